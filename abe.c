@@ -131,8 +131,10 @@ main(int argc, char** argv)
 		test_number();
 		test_gc();
 		test_cons();
+		test_htab();
 		test_atom();
 		test_emit();
+		test_pack();
 	}
 	if (init_sample) {
 		int limit = 100;
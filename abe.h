@@ -17,9 +17,11 @@
 #include "types.h"
 #include "gc.h"
 #include "cons.h"
+#include "htab.h"
 #include "atom.h"
 #include "emit.h"
 #include "actor.h"
+#include "pack.h"
 
 #define	TRACE(x)	x		/* enable/disable trace statements */
 #define	DEBUG(x)			/* enable/disable debug statements */
@@ -11,6 +11,8 @@ DBUG_UNIT("cons");
 
 CELL		nil__cons = { as_cons(&nil__cons), as_cons(&nil__cons), GC_PHASE_Z, 0U };
 static int	cons_cnt = 0;
+static int	hcons_cnt = 0;
+static HTAB*	hcons_table = NULL;		/* weak map from <first,rest> to shared cell */
 
 BOOL
 _nilp(CONS* p)
@@ -44,6 +46,129 @@ cons(CONS* a, CONS* d)
 	return p;
 }
 
+static void
+hcons_sweep()
+/* drop shared cells that the garbage collector is about to free */
+{
+	int n;
+
+	n = (int)htab_prune(hcons_table, gc_garbagep);
+	DBUG_PRINT("hcons", ("%d shared cells collected", n));
+}
+
+static BOOL
+hcons_leafp(CONS* p)
+/* TRUE if <p> is compared by identity alone (not a plain cell) */
+{
+	return (nilp(p) || actorp(p) || !consp(p)) ? TRUE : FALSE;
+}
+
+CONS*
+hcons(CONS* a, CONS* d)
+/*
+ * Return the shared (hash-consed) cell holding <a> and <d>, allocating
+ * it only if no such cell exists.  Cells obtained this way must never
+ * be modified, and <a> and <d> must themselves be shared cells or
+ * leaves (atoms, numbers, actors), so equal trees are always identical.
+ * The table holds weak references, so unreachable shared cells are
+ * still reclaimed by the garbage collector.
+ */
+{
+	CONS* p;
+
+	assert(hcons_leafp(a) || hconsp(a));
+	assert(hcons_leafp(d) || hconsp(d));
+	if (hcons_table == NULL) {
+		hcons_table = new_htab(0);
+		gc_add_weak_hook(hcons_sweep);
+	}
+	p = htab_get(hcons_table, a, d, NULL);
+	if (p != NULL) {
+		(void)car(p);	/* an "aged" cell is live again */
+		return p;
+	}
+	p = cons(a, d);
+	++hcons_cnt;
+	return htab_put(hcons_table, a, d, p);
+}
+
+BOOL
+hconsp(CONS* p)
+/* TRUE if <p> is a shared cell obtained from hcons() */
+{
+	if ((hcons_table == NULL) || nilp(p) || actorp(p) || !consp(p)) {
+		return FALSE;
+	}
+	return (BOOL)(htab_get(hcons_table, car(p), cdr(p), NULL) == p);
+}
+
+#define	HCONS_STACK_SIZE	64		/* pending cells before growing a stack */
+
+static CONS**
+hcons_stack_push(CONS** stack, CONS** stack_buf, int* sp, int* stack_max, CONS* p)
+/* push <p>, moving the stack to larger storage when it is full */
+{
+	if (*sp >= *stack_max) {
+		CONS** q = NEWxN(CONS*, *stack_max * 2);
+
+		assert(q != NULL);
+		memcpy(q, stack, sizeof(CONS*) * *stack_max);
+		if (stack != stack_buf) {
+			free(stack);
+		}
+		stack = q;
+		*stack_max *= 2;
+	}
+	stack[(*sp)++] = p;
+	return stack;
+}
+
+CONS*
+hcons_copy(CONS* form)
+/*
+ * Return a shared (hash-consed) copy of the (acyclic) tree <form>.
+ * Cells are rebuilt bottom-up, using explicit stacks for the pending
+ * cells and their finished copies, so deep trees do not recurse.
+ * Actors and non-cons leaves are shared as-is.
+ */
+{
+	CONS* todo_buf[HCONS_STACK_SIZE];
+	CONS* done_buf[HCONS_STACK_SIZE];
+	CONS** todo = todo_buf;
+	CONS** done = done_buf;
+	int todo_max = HCONS_STACK_SIZE;
+	int done_max = HCONS_STACK_SIZE;
+	int todo_sp = 0;
+	int done_sp = 0;
+	CONS* a;
+	CONS* d;
+
+	todo = hcons_stack_push(todo, todo_buf, &todo_sp, &todo_max, form);
+	while (todo_sp > 0) {
+		form = todo[--todo_sp];
+		if (form == NULL) {		/* both halves of the next cell are done */
+			d = done[--done_sp];
+			a = done[--done_sp];
+			done = hcons_stack_push(done, done_buf, &done_sp, &done_max, hcons(a, d));
+		} else if (nilp(form) || actorp(form) || !consp(form)) {
+			done = hcons_stack_push(done, done_buf, &done_sp, &done_max, form);
+		} else {
+			todo = hcons_stack_push(todo, todo_buf, &todo_sp, &todo_max, NULL);
+			todo = hcons_stack_push(todo, todo_buf, &todo_sp, &todo_max, cdr(form));
+			todo = hcons_stack_push(todo, todo_buf, &todo_sp, &todo_max, car(form));
+		}
+	}
+	assert(done_sp == 1);
+	form = done[0];
+	if (todo != todo_buf) {
+		free(todo);
+	}
+	if (done != done_buf) {
+		free(done);
+	}
+	return form;
+}
+
 CONS*
 _car(CONS* p)
 {
@@ -120,44 +245,126 @@ rplacd(CONS* p, CONS* d)
 #endif
 }
 
+#define	EQUAL_STACK_SIZE	64		/* pairs pending comparison before growing the stack */
+#define	EQUAL_MEMO_LIMIT	32		/* cell pairs compared before memoization kicks in */
+
 BOOL
 equal(CONS* x, CONS* y)
+/*
+ * Structural equality without recursion.  Pending <cdr> comparisons
+ * are kept on an explicit work stack, so deep or long lists use bounded
+ * C stack.  Once a comparison grows beyond a few cells, each pair of
+ * cells compared is remembered, so shared substructure is only scanned
+ * once and cyclic structures terminate (they are equal if they unfold
+ * to the same infinite tree).
+ */
 {
-	if (x == y) {
-		return TRUE;
+	CONS* stack_buf[EQUAL_STACK_SIZE * 2];
+	CONS** stack = stack_buf;
+	int stack_max = EQUAL_STACK_SIZE;
+	int sp = 0;
+	int steps = 0;
+	HTAB* memo = NULL;
+	BOOL result = TRUE;
+
+	if ((x != y) && hconsp(x) && hconsp(y)) {
+		return FALSE;	/* distinct shared cells never hold equal trees */
 	}
-	if (nilp(x) || nilp(y)) {
-		return FALSE;
+	for (;;) {
+		if (x == y) {
+			if (sp == 0) {
+				break;
+			}
+			--sp;
+			x = stack[sp * 2];
+			y = stack[sp * 2 + 1];
+			continue;
+		}
+		if (nilp(x) || nilp(y) || actorp(x) || actorp(y) || !consp(x) || !consp(y)) {
+			result = FALSE;
+			break;
+		}
+		if (memo != NULL) {
+			if (htab_get(memo, x, y, NULL) != NULL) {
+				x = y;	/* already compared (or being compared) */
+				continue;
+			}
+			htab_put(memo, x, y, TRUE);
+		} else if (++steps > EQUAL_MEMO_LIMIT) {
+			memo = new_htab(EQUAL_MEMO_LIMIT * 4);
+		}
+		if (sp >= stack_max) {
+			CONS** p = NEWxN(CONS*, stack_max * 4);
+
+			assert(p != NULL);
+			memcpy(p, stack, sizeof(CONS*) * stack_max * 2);
+			if (stack != stack_buf) {
+				free(stack);
+			}
+			stack = p;
+			stack_max *= 2;
+		}
+		stack[sp * 2] = cdr(x);
+		stack[sp * 2 + 1] = cdr(y);
+		++sp;
+		x = car(x);
+		y = car(y);
 	}
-	if (actorp(x) || actorp(y)) {
-		return FALSE;
+	if (stack != stack_buf) {
+		free(stack);
 	}
-	if (consp(x) && consp(y)) {
-		return (BOOL)(equal(car(x), car(y)) && equal(cdr(x), cdr(y)));
+	if (memo != NULL) {
+		memo = free_htab(memo);
 	}
-	return FALSE;
+	return result;
+}
+
+CONS*
+cons_list(int n, CONS* tail)
+/* allocate a list spine of <n> cells (with NIL elements) ending in <tail> */
+{
+	CONS* p;
+
+	p = gc_cons_n(n, tail);
+	cons_cnt += n;
+	XDBUG_PRINT("cons", ("allocated %d free cells @%p", n, p));
+	return p;
 }
 
 CONS*
 append(CONS* x, CONS* y)
 {
+	CONS* head;
+	CONS* p;
+
 	assert(consp(x));
 	assert(consp(y));
 	if (nilp(x)) {
 		return y;
 	}
-	/* FIXME: consider a non-recursive implementation to minimize stack usage */
-	return cons(car(x), append(cdr(x), y));
+	head = cons_list(length(x), y);
+	for (p = head; !nilp(x); p = cdr(p)) {
+		rplaca(p, car(x));
+		x = cdr(x);
+	}
+	return head;
 }
 
 CONS*
 reverse(CONS* list)
 {
 	CONS* rev = NIL;
+	CONS* spine;
+	CONS* p;
 
+	spine = cons_list(length(list), NIL);
 	while (!nilp(list)) {
 		assert(consp(list));
-		rev = cons(car(list), rev);
+		p = spine;
+		spine = cdr(spine);
+		rplaca(p, car(list));
+		rplacd(p, rev);		/* re-link the batch in reverse order */
+		rev = p;
 		list = cdr(list);
 	}
 	return rev;
@@ -176,33 +383,80 @@ length(CONS* list)
 	return n;
 }
 
+#define	REPLACE_STACK_SIZE	64		/* pending sub-forms before growing the stack */
+
 CONS*
 replace(CONS* form, CONS* map)
-/* replace mapped items in form with corresponding values */
+/*
+ * Replace mapped items in form with corresponding values.
+ *
+ * Each pending item is a sub-form and the new cell whose <first>
+ * receives its replacement.  The <rest> of each copied cell is filled
+ * in by iterating down the list, so neither direction recurses.
+ */
 {
+	CONS* holder = cons(NIL, NIL);
+	CONS* stack_buf[REPLACE_STACK_SIZE * 2];
+	CONS** stack = stack_buf;
+	int stack_max = REPLACE_STACK_SIZE;
+	int sp = 0;
+	CONS* dest;
 	CONS* mapping;
-
-	if (nilp(form)) {
-		form = NIL;
-	} else {
-		mapping = map_find(map, form);
-		if (nilp(mapping)) {
-			if (consp(form)) {
-				/* FIXME: consider a non-recursive implementation to minimize stack usage */
-				form = cons(
-					replace(car(form), map), 
-					replace(cdr(form), map)
-				);
-/* ---- FALL THRU TO RETURN
+	CONS* p;
+	BOOL to_first;
+	BOOL copied;
+
+	stack[sp * 2] = form;
+	stack[sp * 2 + 1] = holder;
+	++sp;
+	while (sp > 0) {
+		--sp;
+		form = stack[sp * 2];
+		dest = stack[sp * 2 + 1];
+		to_first = TRUE;
+		for (;;) {
+			copied = FALSE;
+			if (nilp(form)) {
+				p = NIL;
+			} else if (!nilp(mapping = map_find(map, form))) {
+				p = cdr(mapping);
+			} else if (consp(form)) {
+				p = cons(NIL, NIL);
+				if (sp >= stack_max) {
+					CONS** q = NEWxN(CONS*, stack_max * 4);
+
+					assert(q != NULL);
+					memcpy(q, stack, sizeof(CONS*) * stack_max * 2);
+					if (stack != stack_buf) {
+						free(stack);
+					}
+					stack = q;
+					stack_max *= 2;
+				}
+				stack[sp * 2] = car(form);
+				stack[sp * 2 + 1] = p;
+				++sp;
+				copied = TRUE;
 			} else {
-				form = form;
-*/
+				p = form;
 			}
-		} else {
-			form = cdr(mapping);
+			if (to_first) {
+				rplaca(dest, p);
+			} else {
+				rplacd(dest, p);
+			}
+			if (!copied) {
+				break;
+			}
+			dest = p;
+			form = cdr(form);
+			to_first = FALSE;
 		}
 	}
-	return form;
+	if (stack != stack_buf) {
+		free(stack);
+	}
+	return car(holder);
 }
 
 CONS*
@@ -289,28 +543,62 @@ map_def(CONS* map, CONS* keys, CONS* values)
 	return map;
 }
 
+#define	MAP_REMOVE_HASH_MIN	16		/* map length where hashed duplicate detection pays off */
+
 CONS*
 map_remove(CONS* map, CONS* key)
 /* remove any value associated with key, returning the new map w/ all duplicates removed */
 {
+	HTAB* seen;
 	CONS* m;
 	CONS* p;
+	CONS* q;
 	CONS* k;
-
-	m = NIL;
-	while (!nilp(map)) {
-		assert(consp(map));
+	int n;
+
+	n = length(map);
+	if (n < MAP_REMOVE_HASH_MIN) {
+		m = NIL;
+		while (!nilp(map)) {
+			assert(consp(map));
+			p = car(map);
+			assert(consp(p));
+			k = car(p);
+			if (k != key) {
+				if (nilp(map_find(m, k))) {
+					m = cons(p, m);
+				}
+			}
+			map = cdr(map);
+		}
+		return reverse(m);
+	}
+	/* first pass counts the surviving entries, second pass fills a batch */
+	seen = new_htab(n);
+	htab_put(seen, key, NULL, TRUE);
+	n = 0;
+	for (q = map; !nilp(q); q = cdr(q)) {
+		k = car(car(q));
+		if (htab_get(seen, k, NULL, NULL) == NULL) {
+			htab_put(seen, k, NULL, TRUE);
+			++n;
+		}
+	}
+	clear_htab(seen);
+	htab_put(seen, key, NULL, TRUE);
+	m = cons_list(n, NIL);
+	for (q = m; !nilp(map); map = cdr(map)) {
 		p = car(map);
 		assert(consp(p));
 		k = car(p);
-		if (k != key) {
-			if (nilp(map_find(m, k))) {
-				m = cons(p, m);
-			}
+		if (htab_get(seen, k, NULL, NULL) == NULL) {
+			htab_put(seen, k, NULL, TRUE);
+			rplaca(q, p);
+			q = cdr(q);
 		}
-		map = cdr(map);
 	}
-	return reverse(m);
+	seen = free_htab(seen);
+	return m;
 }
 
 CONS*
@@ -345,6 +633,7 @@ test_cons()
 	CONS* p;
 	CONS* q;
 	CONS* r;
+	int i;
 
 	DBUG_ENTER("test_cons");
 	TRACE(printf("--test_cons--\n"));
@@ -426,6 +715,95 @@ test_cons()
 	assert(length(p) == 2);
 	assert(map_get(p, NUMBER(0)) == NULL);
 	
+	DBUG_PRINT("", ("testing append()/replace()"));
+	p = NIL;
+	for (i = 0; i < 100000; ++i) {
+		p = cons(NUMBER(i), p);
+	}
+	q = append(p, cons(NUMBER(-1), NIL));
+	assert(length(q) == 100001);
+	assert(car(q) == NUMBER(99999));
+	assert(equal(append(p, NIL), p));
+	assert(append(NIL, p) == p);
+	r = reverse(q);
+	assert(car(r) == NUMBER(-1));
+	assert(car(cdr(r)) == NUMBER(0));
+	assert(equal(reverse(r), q));
+	r = map_put(NIL, NUMBER(99999), ATOM("x"));
+	r = map_put(r, NUMBER(1), NIL);
+	q = replace(p, r);
+	assert(car(q) == ATOM("x"));
+	assert(length(q) == 100000);
+	q = replace(cons(p, NUMBER(1)), r);
+	assert(car(car(q)) == ATOM("x"));
+	assert(nilp(cdr(q)));
+	q = str_to_cons("(a (b c) (d (e : f)))");
+	r = map_put(NIL, ATOM("c"), NUMBER(3));
+	r = map_put(r, ATOM("f"), ATOM("g"));
+	assert(equal(replace(q, r), str_to_cons("(a (b 3) (d (e : g)))")));
+
+	DBUG_PRINT("", ("testing map_remove() on long maps"));
+	p = NIL;
+	for (i = 0; i < 1000; ++i) {
+		p = map_put(p, NUMBER(i % 100), NUMBER(i));
+	}
+	q = map_remove(p, NUMBER(42));
+	assert(length(q) == 99);
+	assert(map_get(q, NUMBER(42)) == NULL);
+	assert(map_get(q, NUMBER(7)) == NUMBER(907));
+	assert(car(car(q)) == NUMBER(99));
+
+	DBUG_PRINT("", ("testing equal()"));
+	assert(equal(NIL, NIL));
+	assert(!equal(NIL, cons(NIL, NIL)));
+	assert(equal(cons(NUMBER(1), NIL), cons(NUMBER(1), NIL)));
+	assert(!equal(cons(NUMBER(1), NIL), cons(NUMBER(2), NIL)));
+	p = NIL;
+	q = NIL;
+	for (i = 0; i < 100000; ++i) {		/* deep in both directions */
+		p = cons(cons(p, NUMBER(i)), NIL);
+		q = cons(cons(q, NUMBER(i)), NIL);
+	}
+	assert(equal(p, q));
+	rplacd(car(car(car(q))), NUMBER(-1));
+	assert(!equal(p, q));
+	p = NIL;
+	q = NIL;
+	for (i = 0; i < 64; ++i) {			/* 2^64 paths through shared cells */
+		p = cons(p, p);
+		q = cons(q, q);
+	}
+	assert(equal(p, q));
+	p = cons(NUMBER(0), cons(NUMBER(1), NIL));
+	rplacd(cdr(p), p);					/* circular (0 1 0 1 ...) */
+	q = cons(NUMBER(0), cons(NUMBER(1), cons(NUMBER(0), cons(NUMBER(1), NIL))));
+	rplacd(cdr(cdr(cdr(q))), q);		/* circular (0 1 0 1 ...) */
+	assert(equal(p, q));
+	rplaca(cdr(cdr(q)), NUMBER(2));
+	assert(!equal(p, q));
+
+	DBUG_PRINT("", ("testing hcons()"));
+	p = hcons(NUMBER(1), hcons(NUMBER(2), NIL));
+	q = hcons(NUMBER(1), hcons(NUMBER(2), NIL));
+	assert(p == q);
+	assert(hconsp(p));
+	assert(!hconsp(cons(NUMBER(1), NIL)));
+	r = cons(NUMBER(0), cons(cons(NUMBER(1), cons(NUMBER(2), NIL)), cons(NUMBER(1), cons(NUMBER(2), NIL))));
+	p = hcons_copy(r);
+	assert(p != r);
+	assert(equal(p, r));
+	assert(car(cdr(p)) == cdr(cdr(p)));	/* identical sub-trees are shared */
+	assert(car(cdr(p)) == q);
+	assert(hcons_copy(r) == p);
+	assert(!equal(p, hcons(NUMBER(0), NIL)));
+	r = NIL;
+	for (i = 0; i < 100000; ++i) {
+		r = cons(cons(NUMBER(i & 7), NIL), r);
+	}
+	p = hcons_copy(r);
+	assert(equal(p, r));
+	assert(car(p) == car(cdr(cdr(cdr(cdr(cdr(cdr(cdr(cdr(p))))))))));
+
 	DBUG_RETURN;
 }
 
@@ -434,6 +812,9 @@ report_cons_usage()
 {
 	report_cell_usage();
 	TRACE(printf("cons_cnt=%d\n", cons_cnt));
+	if (hcons_table != NULL) {
+		TRACE(printf("hcons_cnt=%d (%d shared)\n", hcons_cnt, (int)htab_count(hcons_table)));
+	}
 	assert((NIL)->first == NIL);
 	assert((NIL)->rest == NIL);
 }
@@ -37,11 +37,15 @@ BOOL	_nilp(CONS* cons);
 BOOL	_actorp(CONS* cons);
 #endif
 CONS*	cons(CONS* car, CONS* cdr);
+CONS*	hcons(CONS* car, CONS* cdr);	/* shared immutable cell */
+BOOL	hconsp(CONS* cons);
+CONS*	hcons_copy(CONS* form);
 CONS*	_car(CONS* cons);
 CONS*	_cdr(CONS* cons);
 CONS*	rplaca(CONS* cons, CONS* car);
 CONS*	rplacd(CONS* cons, CONS* cdr);
 BOOL	equal(CONS* x, CONS* y);
+CONS*	cons_list(int n, CONS* tail);
 CONS*	append(CONS* x, CONS* y);
 CONS*	reverse(CONS* list);
 int		length(CONS* list);
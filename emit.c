@@ -6,9 +6,15 @@
  *
  * Copyright 2008 Dale Schumacher.  ALL RIGHTS RESERVED.
  */
+#define	_POSIX_C_SOURCE	1	/* for fileno() under -ansi */
 #include "emit.h"
 #include "sbuf.h"
 #include "abe.h"
+#include <limits.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include "dbug.h"
 DBUG_UNIT("emit");
@@ -22,151 +28,196 @@ DBUG_UNIT("emit");
 
 static SBUF* cons_sbuf = NULL;
 
-#define	CONS_BUFSZ	1024
+#define	CONS_STR_RING	8		/* cons_to_str() results valid at once */
 #define	CHILD_DEPTH	3
 #define	TAIL_LENGTH	6
+#define	ATOM_LENGTH	249		/* atom names elided beyond this, when limited */
+#define	STREAM_STACK_SIZE	32	/* pending items before growing the stack */
+#define	READER_BLOCK	(64 * 1024)	/* initial read(2) buffer size */
 
-static void	depth_to_str(int depth, char* buf, CONS* cons);	/* FORWARD */
+typedef struct stream_item STREAM_ITEM;
+struct stream_item {
+	int			kind;		/* one of the STREAM_* item kinds */
+	CONS*		value;		/* value (or list tail) to print */
+	int			depth;		/* remaining nesting depth */
+	int			length;		/* remaining list length */
+	char*		text;		/* literal text */
+};
+
+#define	STREAM_VALUE	0	/* print <value> */
+#define	STREAM_TAIL		1	/* print list elements starting at <value> */
+#define	STREAM_TEXT		2	/* print <text> */
 
 static void
-child_to_str(int depth, char* buf, CONS* cons)
+emit_str(char* s, void (*emit)(char c, void* ctx), void* ctx)
 {
-	char tmp[CONS_BUFSZ];
-	int n;
-	
-	XDBUG_ENTER("child_to_str");
-	n = strlen(buf);
-	XDBUG_PRINT("", ("n = %d", n));
-	if (n < (CONS_BUFSZ - 4)) {
-		depth_to_str(depth, tmp, cons);
-		strncpy(buf + n, tmp, (CONS_BUFSZ - n));
-/*		buf[CONS_BUFSZ - 1] = '\0'; */
-		strcpy((buf + CONS_BUFSZ - 4), ":::");
+	char c;
+
+	while ((c = *s++) != '\0') {
+		(*emit)(c, ctx);
 	}
-	XDBUG_RETURN;
 }
 
-static void
-tail_to_str(int depth, int length, char* buf, CONS* cons)
+static STREAM_ITEM*
+stream_push(STREAM_ITEM* stack, STREAM_ITEM* stack_buf, int* sp, int* stack_max,
+	int kind, CONS* value, int depth, int length, char* text)
+/* push a pending item, moving the stack to larger storage when it is full */
 {
-	int n;
+	STREAM_ITEM* item;
 
-	XDBUG_ENTER("tail_to_str");
-#if 0
-	child_to_str((depth - 1), buf, car(cons));
-	n = strlen(buf);
-	if (n < (CONS_BUFSZ - 3)) {
-		buf[n++] = ',';
-		buf[n++] = ' ';
-		buf[n] = '\0';
+	if (*sp >= *stack_max) {
+		STREAM_ITEM* q = NEWxN(STREAM_ITEM, *stack_max * 2);
+
+		assert(q != NULL);
+		memcpy(q, stack, sizeof(STREAM_ITEM) * *stack_max);
+		if (stack != stack_buf) {
+			free(stack);
+		}
+		stack = q;
+		*stack_max *= 2;
+	}
+	item = &stack[(*sp)++];
+	item->kind = kind;
+	item->value = value;
+	item->depth = depth;
+	item->length = length;
+	item->text = text;
+	return stack;
+}
+
+#define	STREAM_PUSH(k,v,d,n,t) \
+	(stack = stream_push(stack, stack_buf, &sp, &stack_max, (k), (v), (d), (n), (t)))
+
+void
+stream_cons(CONS* cons, int depth, int length, void (*emit)(char c, void* ctx), void* ctx)
+/*
+ * Print <cons> in the cons_to_str() format, one character at a time.
+ * Structure nested more than <depth> levels, and list elements beyond
+ * <length>, are elided as "...".  A negative limit means no limit
+ * (beware of circular structures).  Pending output is kept on an
+ * explicit stack, so the cost is linear in the output produced, there
+ * is no static state, and deep structures do not recurse.
+ */
+{
+	STREAM_ITEM stack_buf[STREAM_STACK_SIZE];
+	STREAM_ITEM* stack = stack_buf;
+	int stack_max = STREAM_STACK_SIZE;
+	int sp = 0;
+	BOOL limited = (((depth >= 0) || (length >= 0)) ? TRUE : FALSE);
+	char buf[64];
+	STREAM_ITEM item;
+
+	XDBUG_ENTER("stream_cons");
+	if (depth < 0) {
+		depth = INT_MAX;
+	}
+	if (length < 0) {
+		length = INT_MAX;
 	}
-	child_to_str((depth - 1), buf, cdr(cons));
+	STREAM_PUSH(STREAM_VALUE, cons, depth, length, NULL);
+	while (sp > 0) {
+		item = stack[--sp];
+		cons = item.value;
+		if (item.kind == STREAM_TEXT) {
+			emit_str(item.text, emit, ctx);
+		} else if (item.kind == STREAM_TAIL) {
+			if (item.length < 0) {			/* length limit */
+				emit_str("...", emit, ctx);
+			} else {
+				CONS* tail = cdr(cons);
+
+				if (nilp(tail) || actorp(tail) || !consp(tail)) {
+					STREAM_PUSH(STREAM_VALUE, tail, (item.depth - 1), length, NULL);
+				} else {
+					STREAM_PUSH(STREAM_TAIL, tail, item.depth, (item.length - 1), NULL);
+				}
+				STREAM_PUSH(STREAM_TEXT, NIL, 0, 0, ", ");
+				STREAM_PUSH(STREAM_VALUE, car(cons), (item.depth - 1), length, NULL);
+			}
+		} else if (nilp(cons)) {
+			emit_str("NIL", emit, ctx);
+		} else if (boolp(cons)) {
+			emit_str((cons ? "TRUE" : "FALSE"), emit, ctx);
+		} else if (atomp(cons)) {
+			char *q = atom_str(cons);
+			int qtd = q[strcspn(q, HUMUS_TOKEN_BRKS)]; /* look for special chars */
+
+			(*emit)('#', ctx);
+			if (qtd) {
+				(*emit)('"', ctx);
+			}
+			if (limited && (strlen(q) > ATOM_LENGTH)) {
+				while (q < (atom_str(cons) + ATOM_LENGTH)) {
+					(*emit)(*q++, ctx);
+				}
+				emit_str("...", emit, ctx);
+			} else {
+				emit_str(q, emit, ctx);
+			}
+			if (qtd) {
+				(*emit)('"', ctx);
+			}
+		} else if (numberp(cons)) {
+			sprintf(buf, "%d", MK_INT(cons));
+			emit_str(buf, emit, ctx);
+#if NUMBER_IS_FUNC
 #else
-	if (length < 0) {			/* length limit */
-		n = strlen(buf);
-		if (n < (CONS_BUFSZ - 4)) {
-			buf[n++] = '.';
-			buf[n++] = '.';
-			buf[n++] = '.';
-			buf[n] = '\0';
-		}
-	} else {
-		child_to_str((depth - 1), buf, car(cons));
-		n = strlen(buf);
-		if (n < (CONS_BUFSZ - 3)) {
-			buf[n++] = ',';
-			buf[n++] = ' ';
-			buf[n] = '\0';
-		}
-		cons = cdr(cons);	/* advance to tail */
-		if (nilp(cons) || actorp(cons) || !consp(cons)) {
-			child_to_str((depth - 1), buf, cons);
+		} else if (funcp(cons)) {
+			sprintf(buf, "^%lx", (ulint)MK_PTR(cons));
+			emit_str(buf, emit, ctx);
+#endif
+		} else if (item.depth < 0) {		/* depth limit */
+			emit_str("...", emit, ctx);
+		} else if (actorp(cons)) {
+			XDBUG_PRINT("", ("actor = @%lx[^%lx, 16#%08lx]", 
+				(ulint)cons, (ulint)_THIS(cons), (ulint)_MINE(cons)));
+			sprintf(buf, "@%lx[^%lx, ", (ulint)cons, (ulint)_THIS(cons));
+			emit_str(buf, emit, ctx);
+			STREAM_PUSH(STREAM_TEXT, NIL, 0, 0, "]");
+			STREAM_PUSH(STREAM_VALUE, _MINE(cons), (item.depth - 1), length, NULL);
+		} else if (consp(cons)) {
+			(*emit)('(', ctx);
+			STREAM_PUSH(STREAM_TEXT, NIL, 0, 0, ")");
+			STREAM_PUSH(STREAM_TAIL, cons, item.depth, length, NULL);
 		} else {
-			tail_to_str(depth, (length - 1), buf, cons);
+			sprintf(buf, "16#%08lx", (ulint)cons);
+			emit_str(buf, emit, ctx);
 		}
 	}
-#endif
+	if (stack != stack_buf) {
+		free(stack);
+	}
 	XDBUG_RETURN;
 }
 
 char*
-cons_to_str(CONS* cons)		/* warning: returns pointer to static buffer, do not nest calls! */
+cons_to_sbuf(SBUF* sbuf, CONS* cons, int depth, int length)
+/* append the printed form of <cons> to <sbuf>, return the whole string */
 {
-	static char buf[CONS_BUFSZ];
-
-	XDBUG_ENTER("cons_to_str");
-	depth_to_str(CHILD_DEPTH, buf, cons);
-	XDBUG_RETURN buf;
+	stream_cons(cons, depth, length, sbuf_emit, sbuf);
+	return sbuf->buf;
 }
 
-static void
-depth_to_str(int depth, char* buf, CONS* cons)
+char*
+cons_to_str(CONS* cons)		/* warning: result is overwritten by later calls! */
+/*
+ * Abbreviated printed form of <cons>, for diagnostics.  Results are
+ * taken from a small ring of buffers, so several results may be used
+ * together (e.g. as arguments to one printf) before being overwritten.
+ */
 {
-	XDBUG_ENTER("depth_to_str");
-	XDBUG_PRINT("", ("depth = %d", depth));
-	strncpy(buf, "", CONS_BUFSZ);	/* zero buffer */
-	if (nilp(cons)) {
-		strcpy(buf, "NIL");
-	} else if (boolp(cons)) {
-		strcpy(buf, (cons ? "TRUE" : "FALSE"));
-	} else if (atomp(cons)) {
-		char *q = atom_str(cons);
-		int n = 0;
-		int qtd = q[strcspn(q, HUMUS_TOKEN_BRKS)]; /* look for special chars */
+	static SBUF* ring[CONS_STR_RING];
+	static int next = 0;
+	SBUF* sbuf;
 
-		buf[n++] = '#';
-		if (qtd) {
-			buf[n++] = '"';
-		}
-		if (strlen(q) > 249) {
-			sprintf((buf + n), "%.249s...", q);
-		} else {
-			strcpy((buf + n), q);
-		}
-		if (qtd) {
-			n = strlen(buf);
-			buf[n++] = '"';
-			buf[n] = '\0';
-		}
-	} else if (numberp(cons)) {
-		sprintf(buf, "%d", MK_INT(cons));
-#if NUMBER_IS_FUNC
-#else
-	} else if (funcp(cons)) {
-		sprintf(buf, "^%lx", (ulint)MK_PTR(cons));
-#endif
-	} else if (depth < 0) {			/* depth limit */
-		strcpy(buf, "...");
-	} else if (actorp(cons)) {
-		int n = 0;
-
-		XDBUG_PRINT("", ("actor = @%lx[^%lx, 16#%08lx]", 
-			(ulint)cons, (ulint)_THIS(cons), (ulint)_MINE(cons)));
-		sprintf(buf, "@%lx[^%lx, ", (ulint)cons, (ulint)_THIS(cons));
-		child_to_str((depth - 1), buf, _MINE(cons));
-		n = strlen(buf);
-		if (n < (CONS_BUFSZ - 2)) {
-			buf[n++] = ']';
-			buf[n] = '\0';
-		}
-	} else if (consp(cons)) {
-		int n = 0;
-
-		XDBUG_PRINT("", ("cons = (16#%08lx, 16#%08lx)", 
-			(ulint)car(cons), (ulint)cdr(cons)));
-		buf[n++] = '(';
-		buf[n] = '\0';
-		tail_to_str(depth, TAIL_LENGTH, buf, cons);
-		n = strlen(buf);
-		if (n < (CONS_BUFSZ - 2)) {
-			buf[n++] = ')';
-			buf[n] = '\0';
-		}
-	} else {
-		sprintf(buf, "16#%08lx", (ulint)cons);
+	XDBUG_ENTER("cons_to_str");
+	sbuf = ring[next];
+	if (sbuf == NULL) {
+		sbuf = ring[next] = new_sbuf(256);
 	}
-	XDBUG_PRINT("", ("buf = %s", buf));
-	XDBUG_RETURN;
+	next = (next + 1) % CONS_STR_RING;
+	clear_sbuf(sbuf);
+	XDBUG_RETURN cons_to_sbuf(sbuf, cons, CHILD_DEPTH, TAIL_LENGTH);
 }
 
 #define	ASSERT_CONS_TO_STR(value, expect, actual) \
@@ -180,6 +231,8 @@ test_cons_to_str()
 	CONS* value;
 	char* actual;
 	char expect[256];
+	SBUF* sbuf;
+	int i;
 
 	DBUG_ENTER("test_cons_to_str");
 	TRACE(printf("--test_cons_to_str--\n"));
@@ -230,6 +283,37 @@ test_cons_to_str()
 	);
 	ASSERT_CONS_TO_STR(value, "(FALSE, (#x, 0), NIL)", actual);
 
+	actual = cons_to_str(NUMBER(1));
+	assert(strcmp("(0, NIL)", cons_to_str(cons(NUMBER(0), NIL))) == 0);
+	assert(strcmp("1", actual) == 0);	/* earlier results survive */
+
+	value = NIL;
+	for (i = 9; i >= 0; --i) {
+		value = cons(NUMBER(i), value);
+	}
+	ASSERT_CONS_TO_STR(value, "(0, 1, 2, 3, 4, 5, 6, ...)", actual);
+	ASSERT_CONS_TO_STR(cons(cons(cons(cons(cons(NIL, NIL), NIL), NIL), NIL), NIL),
+		"((((..., NIL), NIL), NIL), NIL)", actual);
+
+	sbuf = new_sbuf(16);
+	actual = cons_to_sbuf(sbuf, value, -1, -1);
+	assert(strcmp("(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, NIL)", actual) == 0);
+	value = NIL;
+	for (i = 0; i < 100000; ++i) {
+		value = cons(cons(NUMBER(i & 1), NIL), value);
+	}
+	clear_sbuf(sbuf);
+	actual = cons_to_sbuf(sbuf, value, -1, -1);
+	assert(strlen(actual) == ((100000 * 10) + 5));	/* "(" "(1, NIL), " ... "NIL)" */
+	value = NIL;
+	for (i = 0; i < 100000; ++i) {
+		value = cons(value, NIL);
+	}
+	clear_sbuf(sbuf);
+	actual = cons_to_sbuf(sbuf, value, -1, -1);
+	assert(strlen(actual) == ((100000 * 7) + 3));	/* "(" ... "(NIL, NIL)" ... ", NIL)" */
+	sbuf = free_sbuf(sbuf);
+
 	DBUG_RETURN;
 }
 
@@ -647,6 +731,195 @@ str_to_cons(char* in)
 	XDBUG_RETURN out;
 }
 
+/*
+ * A READER yields the complete top-level forms of its input, one at a
+ * time, in the syntax of str_to_cons().  Regular files are mapped into
+ * memory; other descriptors (pipes, terminals) are read in blocks, and
+ * the buffer grows to hold a form of any length.  A form is returned as
+ * soon as it closes, so interactive input need not end with a newline
+ * before it is seen.
+ */
+READER*
+new_reader(FILE* f)
+{
+	READER* rd = NEW(READER);
+	struct stat st;
+	off_t pos;
+	char* base;
+
+	assert(rd != NULL);
+	rd->fd = fileno(f);
+	rd->start = 0;
+	rd->limit = 0;
+	rd->mapped = 0;
+	rd->line = 1;
+	rd->failed = FALSE;
+	if ((fstat(rd->fd, &st) == 0)
+	&& S_ISREG(st.st_mode)
+	&& (st.st_size > 0)
+	&& ((pos = lseek(rd->fd, 0, SEEK_CUR)) >= 0)
+	&& (pos < st.st_size)
+	&& ((base = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, rd->fd, 0)) != MAP_FAILED)) {
+		rd->buf = base;
+		rd->size = st.st_size;
+		rd->start = pos;
+		rd->limit = st.st_size;
+		rd->mapped = st.st_size;
+		rd->fd = -1;		/* everything is already in memory */
+	} else {
+		rd->size = READER_BLOCK;
+		rd->buf = NEWxN(char, rd->size);
+		assert(rd->buf != NULL);
+	}
+	return rd;
+}
+
+READER*
+mem_reader(char* buf, size_t size)
+{
+	READER* rd = NEW(READER);
+
+	assert(rd != NULL);
+	rd->fd = -1;
+	rd->buf = buf;
+	rd->size = size;
+	rd->start = 0;
+	rd->limit = size;
+	rd->mapped = 0;
+	rd->line = 1;
+	rd->failed = FALSE;
+	return rd;
+}
+
+READER*
+free_reader(READER* rd)
+{
+	if (rd->mapped > 0) {
+		munmap(rd->buf, rd->mapped);
+	} else if (rd->fd >= 0) {
+		FREE(rd->buf);
+	}
+	FREE(rd);
+	return NULL;
+}
+
+static size_t
+reader_fill(READER* rd)
+/* append more input to the buffer, 0 at end of input */
+{
+	ssize_t n;
+
+	if (rd->fd < 0) {
+		return 0;
+	}
+	if (rd->start > 0) {
+		rd->limit -= rd->start;
+		memmove(rd->buf, rd->buf + rd->start, rd->limit);
+		rd->start = 0;
+	}
+	if ((rd->limit + 1) >= rd->size) {
+		rd->size <<= 1;
+		rd->buf = (char*)realloc(rd->buf, rd->size);
+		assert(rd->buf != NULL);
+	}
+	n = read(rd->fd, rd->buf + rd->limit, rd->size - rd->limit - 1);	/* leave room for '\0' */
+	if (n <= 0) {
+		return 0;
+	}
+	rd->limit += n;
+	return n;
+}
+
+#define	SCAN_TOKEN	0	/* between tokens */
+#define	SCAN_ATOM	1	/* inside an atom or number */
+#define	SCAN_STRING	2	/* inside a "quoted" token */
+
+CONS*
+read_cons(READER* rd)
+/* next top-level form, NULL at end of input or if malformed (see rd->failed) */
+{
+	size_t n = 0;		/* length of the form so far */
+	int depth = 0;		/* open parentheses */
+	int scan = SCAN_TOKEN;
+	BOOL done = FALSE;
+	char* s;
+	char c;
+	CONS* x;
+
+	DBUG_ENTER("read_cons");
+	while (!done) {
+		if ((rd->start + n) >= rd->limit) {
+			if (reader_fill(rd) == 0) {
+				break;		/* end of input */
+			}
+			continue;
+		}
+		c = rd->buf[rd->start + n];
+		if (scan == SCAN_ATOM) {
+			if (isspace((int)c) || is_reserved(c)) {
+				scan = SCAN_TOKEN;
+				if (depth == 0) {
+					break;		/* the delimiter belongs to what follows */
+				}
+				continue;
+			}
+		} else if (scan == SCAN_STRING) {
+			if (c == '"') {
+				scan = SCAN_TOKEN;
+				done = (depth == 0) ? TRUE : FALSE;
+			}
+		} else if (isspace((int)c)) {
+			if (n == 0) {
+				++rd->start;	/* skip whitespace between forms */
+				if (c == '\n') {
+					++rd->line;
+				}
+				continue;
+			}
+		} else if (c == '(') {
+			++depth;
+		} else if (c == ')') {
+			if (depth > 0) {
+				--depth;
+			}
+			done = (depth == 0) ? TRUE : FALSE;
+		} else if (c == '"') {
+			scan = SCAN_STRING;
+		} else if (c == ':') {
+			done = (depth == 0) ? TRUE : FALSE;	/* malformed alone */
+		} else if (c != '\'') {
+			scan = SCAN_ATOM;
+		}
+		if (c == '\n') {
+			++rd->line;
+		}
+		++n;
+	}
+	if (n == 0) {
+		DBUG_RETURN NULL;	/* end of input */
+	}
+	s = rd->buf + rd->start;
+	if ((rd->start + n) < rd->size) {
+		c = s[n];
+		s[n] = '\0';		/* terminate in place */
+		x = str_to_cons(s);
+		s[n] = c;
+	} else {
+		s = strncpy(NEWxN(char, n + 1), s, n);	/* no room for '\0' */
+		s[n] = '\0';
+		x = str_to_cons(s);
+		FREE(s);
+	}
+	rd->start += n;
+	if (x == NULL) {
+		DBUG_PRINT("", ("syntax error before line %d", rd->line));
+		rd->failed = TRUE;
+	}
+	DBUG_RETURN x;
+}
+
+static void	test_read_cons();		/* FORWARD */
+
 void
 test_str_to_cons()
 {
@@ -789,5 +1062,43 @@ test_str_to_cons()
 	q = cons(cons(ATOM("literal"), cons(ATOM("x"), NIL)), q);
 	assert(equal(p, q));
 	
+	test_read_cons();		/* chain to stream reader tests */
+	DBUG_RETURN;
+}
+
+static void
+test_read_cons()
+{
+	char src[] = " (x\n  (y : z))\n\n'\"a b\"-1 ( ) (";
+	READER* rd;
+	CONS* p;
+
+	DBUG_ENTER("test_read_cons");
+	TRACE(printf("--test_read_cons--\n"));
+	rd = mem_reader(src, strlen(src));
+
+	p = read_cons(rd);
+	DBUG_PRINT("", ("p=%s", cons_to_str(p)));
+	assert(p != NULL);
+	assert(equal(p, str_to_cons("(x (y:z))")));
+	assert(rd->line == 2);
+
+	p = read_cons(rd);
+	assert(p != NULL);
+	assert(equal(p, str_to_cons("(literal \"a b\")")));
+	assert(rd->line == 4);
+
+	p = read_cons(rd);
+	assert(p == NUMBER(-1));
+	
+	p = read_cons(rd);
+	assert(p == NIL);
+	assert(!rd->failed);
+
+	p = read_cons(rd);		/* unclosed at end of input */
+	assert(p == NULL);
+	assert(rd->failed);
+
+	rd = free_reader(rd);
 	DBUG_RETURN;
 }
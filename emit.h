@@ -9,13 +9,34 @@
 #ifndef EMIT_H
 #define EMIT_H
 
+#include <stdio.h>
 #include "cons.h"
+#include "sbuf.h"
+
+typedef struct form_reader READER;
+struct form_reader {
+	int		fd;			/* descriptor to read(2) more from, or -1 */
+	char*	buf;		/* source text */
+	size_t	size;		/* writable bytes at <buf> */
+	size_t	start;		/* offset of the next unread character */
+	size_t	limit;		/* offset just past the buffered text */
+	size_t	mapped;		/* length of the mmap()ed file, 0 if not mapped */
+	int		line;		/* line number of <start> */
+	BOOL	failed;		/* TRUE after a malformed form */
+};
 
 void	file_emit(char c, void* ctx);
 void	emit_cons(CONS* cons, int indent, void (*emit)(char c, void* ctx), void* ctx);
-char*	cons_to_str(CONS* cons);	/* warning: returns pointer to static buffer, do not nest calls! */
+void	stream_cons(CONS* cons, int depth, int length, void (*emit)(char c, void* ctx), void* ctx);
+char*	cons_to_sbuf(SBUF* sbuf, CONS* cons, int depth, int length);	/* limit < 0 is unlimited */
+char*	cons_to_str(CONS* cons);	/* warning: result is overwritten by later calls! */
 CONS*	str_to_cons(char* s);
 
+READER*	new_reader(FILE* f);	/* read top-level forms from <f> */
+READER*	mem_reader(char* buf, size_t size);	/* <buf> must be writable */
+READER*	free_reader(READER* rd);
+CONS*	read_cons(READER* rd);	/* NULL at end of input, or if rd->failed */
+
 void	test_emit();
 void	test_str_to_cons();
 
@@ -20,6 +20,10 @@ CELL	gc_fresh__cell = { as_cons(0U), NIL, GC_PHASE_Z, 0U };
 CELL	gc_free__cell = { as_cons(0U), NIL, GC_PHASE_Z, 0U };
 CELL	gc_perm__cell = { as_cons(0U), NIL, GC_PHASE_Z, 0U };
 
+#define	GC_WEAK_HOOKS	4
+static void	(*gc_weak_hook[GC_WEAK_HOOKS])();	/* purge weak references before freeing cells */
+static int	gc_weak_hooks = 0;
+
 static void
 gc_initialize()
 {
@@ -261,8 +265,13 @@ static void
 gc_free_cells()
 /* move unmarked "aged" cells to "free" list after scanning */
 {
+	int i;
+
 	DBUG_ENTER("gc_free_cells");
 	DBUG_PRINT("gc", ("%u cells marked in-use on fresh list", GC_SIZE(GC_FRESH_LIST)));
+	for (i = 0; i < gc_weak_hooks; ++i) {
+		(*gc_weak_hook[i])();	/* unmarked cells are still "aged", so gc_garbagep() can find them */
+	}
 	gc_append_list(GC_FREE_LIST, GC_AGED_LIST);	
 	DBUG_PRINT("gc", ("%u cells available in free list", GC_SIZE(GC_FREE_LIST)));
 #if 1	/* FIXME: eventually remove these checks for better performance */
@@ -330,6 +339,39 @@ gc_actor_collection(CONFIG* cfg, CONS* root)
 	DBUG_RETURN;
 }
 
+void
+gc_add_weak_hook(void (*hook)())
+/* register a function to drop weak references to garbage (see gc_garbagep) */
+{
+	assert(gc_weak_hooks < GC_WEAK_HOOKS);
+	gc_weak_hook[gc_weak_hooks++] = hook;
+}
+
+BOOL
+gc_garbagep(CONS* cell)
+/* TRUE if <cell> is about to be reclaimed (valid only within the weak hook) */
+{
+	if (actorp(cell)) {
+		cell = MK_CONS(cell);
+	}
+	if (nilp(cell) || !consp(cell)) {
+		return FALSE;
+	}
+	return (BOOL)(GC_MARK(as_cell(cell)) == gc_phase__prev);
+}
+
+static void
+gc_check_value(CONS* s)
+/* ensure that "aged" cells stored into other cells are considered "live" */
+{
+	if (actorp(s)) {
+		s = MK_CONS(s);
+	}
+	if (!nilp(s) && consp(s) && (GC_MARK(as_cell(s)) == gc_phase__prev)) {
+		gc_scan_cell(as_cell(s));
+	}
+}
+
 static void
 gc_allocate_cells(CELL* list_head)
 /* allocate a new block of free cells */
@@ -391,6 +433,8 @@ gc_cons(CONS* first, CONS* rest)
 	}
 	p = gc_pop(GC_FREE_LIST);
 	assert(p != NULL);
+	gc_check_value(first);	/* a "fresh" cell is never scanned, so */
+	gc_check_value(rest);	/* anything it refers to must be "live" */
 	GC_SET_MARK(p, gc_phase__mark);
 	GC_SET_FIRST(p, first);
 	GC_SET_REST(p, rest);
@@ -401,6 +445,37 @@ gc_cons(CONS* first, CONS* rest)
 	return s;
 }
 
+CONS*
+gc_cons_n(int n, CONS* rest)
+/* allocate a list of <n> new cells (with NIL firsts) ending in <rest> */
+{
+	CELL* p;
+	CONS* head = rest;
+	CELL* tail = NULL;
+
+	assert(n >= 0);
+	gc_check_value(rest);
+	while (GC_SIZE(GC_FREE_LIST) < n) {
+		gc_allocate_cells(GC_FREE_LIST);
+	}
+	while (n-- > 0) {
+		p = gc_pop(GC_FREE_LIST);
+		assert(p != NULL);
+		GC_SET_MARK(p, gc_phase__mark);
+		GC_SET_FIRST(p, NIL);
+		GC_SET_REST(p, rest);
+		gc_put(GC_FRESH_LIST, p);
+		if (tail == NULL) {
+			head = as_cons(p);
+		} else {
+			GC_SET_REST(tail, as_cons(p));
+		}
+		tail = p;
+	}
+	assert(consp(head));
+	return head;
+}
+
 static CELL*
 gc_check_access(CONS* cell)
 /* ensure that accessed cells are considered "live" */
@@ -437,6 +512,7 @@ void
 gc_set_first(CONS* cell, CONS* first)
 {
 	assert(!nilp(cell));
+	gc_check_value(first);	/* <cell> may already have been scanned */
 	GC_SET_FIRST(gc_check_access(cell), first);
 }
 
@@ -444,6 +520,7 @@ void
 gc_set_rest(CONS* cell, CONS* rest)
 {
 	assert(!nilp(cell));
+	gc_check_value(rest);	/* <cell> may already have been scanned */
 	GC_SET_REST(gc_check_access(cell), rest);
 }
 
@@ -578,6 +655,32 @@ test_gc()
 	assert(GC_SIZE(GC_FRESH_LIST) == 1);
 	assert(GC_SIZE(GC_FREE_LIST) == (N - 1));
 
+	s = gc_cons(NUMBER(3), NIL);
+	gc_age_cells();
+	gc_scan_cell(as_cell(r));	/* scan "root" */
+	assert(gc_refresh_cell() == TRUE);
+	gc_set_rest(r, s);			/* store "aged" cell into scanned cell */
+	assert(GC_SIZE(GC_AGED_LIST) == 0);
+	assert(GC_SIZE(GC_SCAN_LIST) == 1);
+	while (gc_refresh_cell() == TRUE)
+		;
+	gc_free_cells();
+	assert(GC_SIZE(GC_FRESH_LIST) == 2);
+	assert(GC_SIZE(GC_FREE_LIST) == (N - 2));
+
+	gc_age_cells();
+	gc_scan_cell(as_cell(r));	/* scan "root" */
+	s = gc_cons(NUMBER(4), gc_rest(r));	/* store "aged" cell into fresh cell */
+	gc_set_rest(r, s);
+	assert(GC_SIZE(GC_AGED_LIST) == 0);
+	assert(GC_SIZE(GC_SCAN_LIST) == 2);
+	while (gc_refresh_cell() == TRUE)
+		;
+	gc_free_cells();
+	assert(GC_SIZE(GC_FRESH_LIST) == 3);
+	assert(GC_SIZE(GC_FREE_LIST) == (N - 3));
+	assert(gc_first(gc_rest(gc_rest(r))) == NUMBER(3));
+
 	gc_sanity_check(GC_AGED_LIST);
 	gc_sanity_check(GC_SCAN_LIST);
 	gc_sanity_check(GC_FRESH_LIST);
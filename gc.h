@@ -62,11 +62,15 @@ void	gc_sanity_check(CELL* list);			/* check <list> for internal consistency */
 
 CONS*	gc_perm(CONS* first, CONS* rest);		/* allocate and initialize a permanent cell */
 CONS*	gc_cons(CONS* first, CONS* rest);		/* allocate and initialize a new "cons" cell */
+CONS*	gc_cons_n(int n, CONS* rest);			/* allocate a batch of <n> new cells as a list */
 CONS*	gc_first(CONS* cell);					/* retrieve the first of the list */
 CONS*	gc_rest(CONS* cell);					/* retrieve the rest of the list */
 void	gc_set_first(CONS* cell, CONS* first);	/* overwrite the first of the list */
 void	gc_set_rest(CONS* cell, CONS* rest);	/* overwrite the rest of the list */
 
+void	gc_add_weak_hook(void (*hook)());	/* called before unmarked cells are freed */
+BOOL	gc_garbagep(CONS* cell);				/* TRUE if <cell> is about to be freed */
+
 void	gc_full_collection(CONS* root);			/* perform a full garbage collection (NOT CONCURRENT!) */
 void	gc_actor_collection(CONFIG* cfg, CONS* root); /* initiate actor-based (CONCURRENT) collection */
 void	test_gc();								/* internal unit test */
@@ -0,0 +1,279 @@
+/*
+ * htab.c -- Open-addressed hash tables keyed on pointer pairs
+ *
+ * Keys are compared by identity (never by structure), so the
+ * tables are suitable for memoizing cells, atoms and actors.
+ * Collisions are resolved by linear probing.
+ *
+ * NOTE: hash tables live in malloc() storage, which is NOT scanned
+ *       by the garbage collector.  Anything referenced only from
+ *       a table must be protected some other way.
+ *
+ * Copyright 2009 Dale Schumacher.  ALL RIGHTS RESERVED.
+ */
+#include "htab.h"
+#include "abe.h"
+
+#include "dbug.h"
+DBUG_UNIT("htab");
+
+static CELL		htab_empty__cell;		/* sentinel marking never-used slots */
+static CELL		htab_deleted__cell;		/* sentinel marking removed entries */
+
+#define	HTAB_EMPTY		as_cons(&htab_empty__cell)
+#define	HTAB_DELETED	as_cons(&htab_deleted__cell)
+
+#define	HTAB_MIN_SIZE	16
+
+static size_t
+htab_hash(CONS* key0, CONS* key1)
+{
+	ulint h = (ulint)key0;
+
+	h ^= ((ulint)key1 << 7) ^ ((ulint)key1 >> 5);
+	h *= 2654435761UL;
+	h ^= (h >> 15);
+	return (size_t)h;
+}
+
+static void
+htab_init_slots(HTAB* htab, size_t limit)
+{
+	size_t i;
+
+	htab->limit = limit;
+	htab->count = 0;
+	htab->used = 0;
+	htab->slot = NEWxN(HENTRY, limit);
+	assert(htab->slot != NULL);
+	for (i = 0; i < limit; ++i) {
+		htab->slot[i].key0 = HTAB_EMPTY;
+	}
+}
+
+HTAB*
+new_htab(size_t size)
+{
+	HTAB* htab = NEW(HTAB);
+	size_t limit = HTAB_MIN_SIZE;
+
+	assert(htab != NULL);
+	while (limit < (size + (size >> 1))) {
+		limit <<= 1;
+	}
+	htab_init_slots(htab, limit);
+	return htab;
+}
+
+void
+clear_htab(HTAB* htab)
+{
+	size_t i;
+
+	for (i = 0; i < htab->limit; ++i) {
+		htab->slot[i].key0 = HTAB_EMPTY;
+	}
+	htab->count = 0;
+	htab->used = 0;
+}
+
+HTAB*
+free_htab(HTAB* htab)
+{
+	free(htab->slot);
+	free(htab);
+	return NULL;
+}
+
+static HENTRY*
+htab_lookup(HTAB* htab, CONS* key0, CONS* key1)
+/* return the slot holding <key0,key1>, or the first free slot in its probe sequence */
+{
+	size_t mask = htab->limit - 1;
+	size_t i = htab_hash(key0, key1) & mask;
+	HENTRY* free_slot = NULL;
+	HENTRY* e;
+
+	for (;;) {
+		e = &htab->slot[i];
+		if (e->key0 == HTAB_EMPTY) {
+			return ((free_slot != NULL) ? free_slot : e);
+		}
+		if (e->key0 == HTAB_DELETED) {
+			if (free_slot == NULL) {
+				free_slot = e;
+			}
+		} else if ((e->key0 == key0) && (e->key1 == key1)) {
+			return e;
+		}
+		i = (i + 1) & mask;
+	}
+}
+
+static void
+htab_resize(HTAB* htab, size_t limit)
+{
+	HENTRY* old_slot = htab->slot;
+	size_t old_limit = htab->limit;
+	size_t i;
+
+	DBUG_PRINT("htab", ("resize %u -> %u (count=%u)", old_limit, limit, htab->count));
+	htab_init_slots(htab, limit);
+	for (i = 0; i < old_limit; ++i) {
+		HENTRY* e = &old_slot[i];
+
+		if ((e->key0 != HTAB_EMPTY) && (e->key0 != HTAB_DELETED)) {
+			*htab_lookup(htab, e->key0, e->key1) = *e;
+			++htab->count;
+			++htab->used;
+		}
+	}
+	free(old_slot);
+}
+
+CONS*
+htab_get(HTAB* htab, CONS* key0, CONS* key1, CONS* def)
+/* return the value associated with <key0,key1>, or <def> if not found */
+{
+	HENTRY* e = htab_lookup(htab, key0, key1);
+
+	if ((e->key0 == HTAB_EMPTY) || (e->key0 == HTAB_DELETED)) {
+		return def;
+	}
+	return e->value;
+}
+
+CONS*
+htab_put(HTAB* htab, CONS* key0, CONS* key1, CONS* value)
+/* associate <value> with <key0,key1>, replacing any previous value */
+{
+	HENTRY* e;
+
+	assert((key0 != HTAB_EMPTY) && (key0 != HTAB_DELETED));
+	if (((htab->used + 1) << 2) > (htab->limit * 3)) {
+		htab_resize(htab, ((htab->count << 2) > htab->limit) ? (htab->limit << 1) : htab->limit);
+	}
+	e = htab_lookup(htab, key0, key1);
+	if (e->key0 == HTAB_EMPTY) {
+		++htab->used;
+		++htab->count;
+	} else if (e->key0 == HTAB_DELETED) {
+		++htab->count;
+	}
+	e->key0 = key0;
+	e->key1 = key1;
+	e->value = value;
+	return value;
+}
+
+BOOL
+htab_remove(HTAB* htab, CONS* key0, CONS* key1)
+/* remove any value associated with <key0,key1>, return TRUE if found */
+{
+	HENTRY* e = htab_lookup(htab, key0, key1);
+
+	if ((e->key0 == HTAB_EMPTY) || (e->key0 == HTAB_DELETED)) {
+		return FALSE;
+	}
+	e->key0 = HTAB_DELETED;
+	e->value = NULL;
+	--htab->count;
+	return TRUE;
+}
+
+size_t
+htab_prune(HTAB* htab, BOOL (*dead)(CONS* value))
+/* remove every entry whose value satisfies <dead>, return the number removed */
+{
+	size_t n = 0;
+	size_t i;
+
+	for (i = 0; i < htab->limit; ++i) {
+		HENTRY* e = &htab->slot[i];
+
+		if ((e->key0 != HTAB_EMPTY) && (e->key0 != HTAB_DELETED) && (*dead)(e->value)) {
+			e->key0 = HTAB_DELETED;
+			e->value = NULL;
+			--htab->count;
+			++n;
+		}
+	}
+	return n;
+}
+
+size_t
+htab_prune_entries(HTAB* htab, BOOL (*dead)(HENTRY* e))
+/* remove every entry (keys and value) that satisfies <dead>, return the number removed */
+{
+	size_t n = 0;
+	size_t i;
+
+	for (i = 0; i < htab->limit; ++i) {
+		HENTRY* e = &htab->slot[i];
+
+		if ((e->key0 != HTAB_EMPTY) && (e->key0 != HTAB_DELETED) && (*dead)(e)) {
+			e->key0 = HTAB_DELETED;
+			e->value = NULL;
+			--htab->count;
+			++n;
+		}
+	}
+	return n;
+}
+
+static BOOL
+htab_test_odd(CONS* value)
+{
+	return (BOOL)(MK_INT(value) & 1);
+}
+
+static BOOL
+htab_test_false_key(HENTRY* e)
+{
+	return (BOOL)(e->key0 == FALSE);
+}
+
+void
+test_htab()
+{
+	HTAB* htab;
+	CONS* p;
+	int i;
+
+	DBUG_ENTER("test_htab");
+	TRACE(printf("--test_htab--\n"));
+	htab = new_htab(0);
+	assert(htab_count(htab) == 0);
+	assert(htab_get(htab, NIL, NULL, NULL) == NULL);
+	assert(htab_put(htab, NIL, NULL, TRUE) == TRUE);
+	assert(htab_get(htab, NIL, NULL, NULL) == TRUE);
+	assert(htab_get(htab, NIL, NIL, NULL) == NULL);
+	assert(htab_put(htab, FALSE, FALSE, NUMBER(0)) == NUMBER(0));
+	assert(htab_get(htab, FALSE, FALSE, NULL) == NUMBER(0));
+	assert(htab_count(htab) == 2);
+
+	for (i = 0; i < 1000; ++i) {
+		htab_put(htab, NUMBER(i), NUMBER(-i), NUMBER(i * i));
+	}
+	assert(htab_count(htab) == 1002);
+	for (i = 0; i < 1000; i += 2) {
+		assert(htab_remove(htab, NUMBER(i), NUMBER(-i)) == TRUE);
+	}
+	assert(htab_remove(htab, NUMBER(0), NUMBER(0)) == FALSE);
+	assert(htab_count(htab) == 502);
+	for (i = 0; i < 1000; ++i) {
+		p = htab_get(htab, NUMBER(i), NUMBER(-i), NIL);
+		assert(p == ((i & 1) ? NUMBER(i * i) : NIL));
+	}
+	assert(htab_prune(htab, htab_test_odd) == 500);
+	assert(htab_count(htab) == 2);
+	assert(htab_get(htab, FALSE, FALSE, NULL) == NUMBER(0));
+	assert(htab_prune_entries(htab, htab_test_false_key) == 1);
+	assert(htab_count(htab) == 1);
+	assert(htab_get(htab, FALSE, FALSE, NULL) == NULL);
+	clear_htab(htab);
+	assert(htab_count(htab) == 0);
+	assert(htab_get(htab, NIL, NULL, NULL) == NULL);
+	htab = free_htab(htab);
+	DBUG_RETURN;
+}
@@ -0,0 +1,40 @@
+/*
+ * htab.h -- Open-addressed hash tables keyed on pointer pairs
+ *
+ * Copyright 2009 Dale Schumacher.  ALL RIGHTS RESERVED.
+ */
+#ifndef HTAB_H
+#define HTAB_H
+
+#include <stddef.h>
+#include "types.h"
+
+typedef struct hash_entry HENTRY;
+struct hash_entry {
+	CONS*		key0;		/* primary key (internal sentinels reserved) */
+	CONS*		key1;		/* secondary key (NULL for single-key tables) */
+	CONS*		value;		/* associated value */
+};
+
+typedef struct hash_table HTAB;
+struct hash_table {
+	size_t		limit;		/* number of slots (always a power of 2) */
+	size_t		count;		/* number of live entries */
+	size_t		used;		/* number of live + deleted entries */
+	HENTRY*		slot;		/* slot array */
+};
+
+HTAB*	new_htab(size_t size);
+void	clear_htab(HTAB* htab);
+HTAB*	free_htab(HTAB* htab);
+CONS*	htab_get(HTAB* htab, CONS* key0, CONS* key1, CONS* def);
+CONS*	htab_put(HTAB* htab, CONS* key0, CONS* key1, CONS* value);
+BOOL	htab_remove(HTAB* htab, CONS* key0, CONS* key1);
+size_t	htab_prune(HTAB* htab, BOOL (*dead)(CONS* value));
+size_t	htab_prune_entries(HTAB* htab, BOOL (*dead)(HENTRY* e));
+
+#define	htab_count(t)	((t)->count)
+
+void	test_htab();
+
+#endif /* HTAB_H */
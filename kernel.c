@@ -7,13 +7,24 @@ static char	_Program[] = "Kernel";
 static char	_Version[] = "2012-03-25";
 static char	_Copyright[] = "Copyright 2012 Dale Schumacher";
 
+#define	_POSIX_C_SOURCE	1	/* for fileno() under -ansi */
 #include <getopt.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
 #include "kernel.h"
 
 #include "dbug.h"
 DBUG_UNIT("kernel");
 
 static int M_limit = 1000;  /* actor messaging dispatch limit */
+static BOOL hash_cons_pairs = FALSE;  /* share identical immutable pairs */
+static char* image_in = NULL;  /* heap image to load at startup */
+static char* image_out = NULL;  /* heap image to save after loading files */
+static BOOL use_cache = FALSE;  /* restore library files from their caches */
 
 static BEH_PROTO;	/* ==== GLOBAL ACTOR CONFIGURATION ==== */
 static FILE* input_file = NULL;
@@ -30,6 +41,106 @@ static CONS* a_kernel_env;
 static CONS* a_ground_env;
 
 static CONS* intern_map;  /* pr(value->const, name->symbol) */
+static HTAB* intern_index = NULL;  /* (value|name, type) -> const|symbol */
+
+/*
+ * Message selectors understood by the object behaviors are interned once
+ * and given small integer ids, so each behavior dispatches on its request
+ * with a single switch instead of a chain of atom comparisons.  A request
+ * matches a selector only if it has the selector's shape: the bare atom
+ * (depth 0) or a list of at least <depth> pairs headed by the atom.
+ */
+enum selector {
+	SEL_NONE = 0,
+	SEL_TYPE_EQ,
+	SEL_EVAL,
+	SEL_COMB,
+	SEL_MATCH,
+	SEL_LEFT_MATCH,
+	SEL_RIGHT_MATCH,
+	SEL_LOOKUP,
+	SEL_BIND,
+	SEL_IF,
+	SEL_MAP,
+	SEL_FOLDL,
+	SEL_SET_CAR,
+	SEL_SET_CDR,
+	SEL_WRITE_TAIL,
+	SEL_WRITE,
+	SEL_COPY_IMMUTABLE,
+	SEL_AS_PAIR,
+	SEL_AS_TUPLE,
+	SEL_UNWRAP,
+	SEL_VALUE,
+	SEL_COUNT
+};
+
+static struct {
+	char*		name;
+	int			depth;		/* number of pairs in a well-formed request */
+} sel_info[SEL_COUNT] = {
+	{ NULL,			0 },
+	{ "type_eq",		1 },
+	{ "eval",			1 },
+	{ "comb",			2 },
+	{ "match",			2 },
+	{ "left_match",		2 },
+	{ "right_match",	2 },
+	{ "lookup",			1 },
+	{ "bind",			2 },
+	{ "if",				3 },
+	{ "map",			1 },
+	{ "foldl",			3 },
+	{ "set_car",		1 },
+	{ "set_cdr",		1 },
+	{ "write_tail",		1 },
+	{ "write",			0 },
+	{ "copy_immutable",	0 },
+	{ "as_pair",		0 },
+	{ "as_tuple",		0 },
+	{ "unwrap",			0 },
+	{ "value",			0 },
+};
+
+static CONS* sel_atom[SEL_COUNT];  /* selector id -> atom */
+static HTAB* sel_index = NULL;  /* atom -> NUMBER(selector id) */
+
+#define	SEL(name)	(sel_atom[SEL_##name])
+
+static void
+init_selectors()
+{
+	int id;
+
+	sel_index = new_htab(SEL_COUNT);
+	for (id = SEL_NONE + 1; id < SEL_COUNT; ++id) {
+		sel_atom[id] = ATOM(sel_info[id].name);
+		htab_put(sel_index, sel_atom[id], NULL, NUMBER(id));
+	}
+}
+
+static int
+req_selector(CONS* req)  /* SELECTOR ID FOR A WELL-FORMED req, OR SEL_NONE */
+{
+	CONS* p;
+	int depth;
+	int id;
+
+	if (!is_pr(req)) {
+		id = MK_INT(htab_get(sel_index, req, NULL, NUMBER(SEL_NONE)));
+		return ((sel_info[id].depth == 0) ? id : SEL_NONE);
+	}
+	id = MK_INT(htab_get(sel_index, hd(req), NULL, NUMBER(SEL_NONE)));
+	if (sel_info[id].depth == 0) {
+		return SEL_NONE;
+	}
+	for (depth = 1, p = tl(req); depth < sel_info[id].depth; ++depth, p = tl(p)) {
+		if (!is_pr(p)) {
+			return SEL_NONE;
+		}
+	}
+	return id;
+}
 
 typedef CONS* (*LAMBDA_x)(CONS* x);
 typedef CONS* (*LAMBDA_x_y)(CONS* x, CONS* y);
@@ -42,6 +153,10 @@ typedef CONS* (*LAMBDA_x_y_z)(CONS* x, CONS* y, CONS* z);
 
 #define	THROW(msg)		SEND(ACTOR(throw_beh, NIL), (msg))
 
+static void flush_output();  /* forward */
+
+static long throw_cnt = 0;  /* number of exceptions reported */
+
 /**
 throw_beh = \msg.[
 	# report an exception
@@ -54,6 +169,8 @@ BEH_DECL(throw_beh)
 
 	DBUG_ENTER("throw_beh");
 	DBUG_PRINT("FAIL!", ("%s", msg));
+	++throw_cnt;
+	flush_output();
 	fprintf(output_file, "FAIL! %s\n", msg);
 	fflush(output_file);
 	DBUG_RETURN;
@@ -71,6 +188,7 @@ BEH_DECL(abort_beh)
 
 	DBUG_ENTER("abort_beh");
 	DBUG_PRINT("ABORT!", ("%s", msg));
+	flush_output();
 	fprintf(stderr, "ABORT! %s\n", msg);
 	abort();
 	DBUG_RETURN;
@@ -79,61 +197,102 @@ BEH_DECL(abort_beh)
 static char*
 printable(CONS* p)		/* WARNING! you must free this storage manually */
 {
+	SBUF* sbuf = new_sbuf(64);
 	char* s;
-	char* t;
-	
-	s = cons_to_str(p);  /* pointer to static buffer */
-	if (atomp(p)) { ++s; }  /* skip leading '#' */
-	t = NEWxN(char, strlen(s) + 1);
-	return strcpy(t, s);
+
+	cons_to_sbuf(sbuf, p, -1, -1);  /* full printed form */
+	s = sbuf_release(sbuf);
+	if (atomp(p)) {  /* skip leading '#' */
+		memmove(s, s + 1, strlen(s));
+	}
+	return s;
 }
 
+#define	SINK_BLOCK	4096	/* bytes buffered before writing to a file */
+
 typedef struct sink_t SINK;
 struct sink_t {
 	CONS*		context;
 	CONS*		(*put)(SINK*, CONS*);  /* transmit value, return a_true on success */
 	CONS*		(*put_cstr)(SINK*, char*);  /* transmit C-string, a_true on success */
+	CONS*		(*put_bytes)(SINK*, char*, size_t);  /* transmit n bytes, a_true on success */
+	CONS*		(*flush)(SINK*);  /* deliver buffered output, a_true on success */
+	FILE*		file;		/* output file (file sinks only) */
+	char*		buf;		/* block buffer (file sinks only) */
+	size_t		count;		/* number of bytes waiting in <buf> */
+	size_t		total;		/* number of bytes accepted so far */
 };
 
 CONS*
-file_put(SINK* sink, CONS* value)
+file_flush(SINK* sink)
 {
-	FILE* f;
-	int c;
-	CONS* ok;
+	CONS* ok = a_true;
 
-	DBUG_ENTER("file_put");
-	assert(numberp(value));
-	XDBUG_PRINT("stdout", ("%p", stdout));
-	XDBUG_PRINT("stderr", ("%p", stderr));
-	XDBUG_PRINT("output_file", ("%p", output_file));
-	if (sink->context == MK_REF(output_file)) {
-		f = output_file;  /* FIXME: WORKAROUND FOR FILE* ENCODING */
-	} else {
-		f = (FILE*)(MK_PTR(sink->context));
+	DBUG_ENTER("file_flush");
+	DBUG_PRINT("count", ("%u", (unsigned)sink->count));
+	if ((sink->count > 0)
+	&& (fwrite(sink->buf, 1, sink->count, sink->file) != sink->count)) {
+		ok = a_false;
+	}
+	sink->count = 0;
+	if (fflush(sink->file) == EOF) {
+		ok = a_false;
 	}
-	XDBUG_PRINT("f", ("%p", f));
-	c = MK_INT(value);
-	DBUG_PRINT("c", ((isprint(c) ? "%d '%c'" : "%d '\\x%X'"), c, c));
-	ok = ((fputc(c, f) == EOF) ? a_false : a_true);
-	XDBUG_PRINT("ok", ("%s", cons_to_str(ok)));
 	DBUG_RETURN ok;
 }
 CONS*
-generic_put_cstr(SINK* sink, char* s)
+file_put_bytes(SINK* sink, char* s, size_t n)
+{
+	DBUG_ENTER("file_put_bytes");
+	if ((sink->count + n) > SINK_BLOCK) {
+		if ((sink->flush)(sink) == a_false) {
+			DBUG_RETURN a_false;
+		}
+		if (n >= SINK_BLOCK) {  /* too big to buffer */
+			sink->total += n;
+			DBUG_RETURN ((fwrite(s, 1, n, sink->file) == n) ? a_true : a_false);
+		}
+	}
+	sink->total += n;
+	memcpy(sink->buf + sink->count, s, n);
+	sink->count += n;
+	DBUG_RETURN a_true;
+}
+CONS*
+file_put(SINK* sink, CONS* value)
 {
 	int c;
 
-	DBUG_ENTER("generic_put_cstr");
-	assert(s != NULL);
-	DBUG_PRINT("s", ((s ? "\"%s\"" : "NULL"), s));
-	while ((c = *s++)) {
-		if((sink->put)(sink, NUMBER(c)) == a_false) {
+	XDBUG_ENTER("file_put");
+	assert(numberp(value));
+	c = MK_INT(value);
+	XDBUG_PRINT("c", ((isprint(c) ? "%d '%c'" : "%d '\\x%X'"), c, c));
+	if ((sink->count >= SINK_BLOCK) && ((sink->flush)(sink) == a_false)) {
+		XDBUG_RETURN a_false;
+	}
+	sink->buf[sink->count++] = (char)c;
+	++sink->total;
+	XDBUG_RETURN a_true;
+}
+CONS*
+generic_put_bytes(SINK* sink, char* s, size_t n)
+{
+	DBUG_ENTER("generic_put_bytes");
+	while (n-- > 0) {
+		if ((sink->put)(sink, NUMBER((unsigned char)*s++)) == a_false) {
 			DBUG_RETURN a_false;
 		}
 	}
 	DBUG_RETURN a_true;
 }
+CONS*
+generic_put_cstr(SINK* sink, char* s)
+{
+	DBUG_ENTER("generic_put_cstr");
+	assert(s != NULL);
+	DBUG_PRINT("s", ((s ? "\"%s\"" : "NULL"), s));
+	DBUG_RETURN (sink->put_bytes)(sink, s, strlen(s));
+}
 SINK*
 file_sink(FILE* f)
 {
@@ -142,63 +301,88 @@ file_sink(FILE* f)
 	DBUG_ENTER("file_sink");
 	DBUG_PRINT("f", ("%p", f));
 	sink = NEW(SINK);
-	sink->context = MK_REF(f);
+	assert(sink != NULL);
+	sink->context = NIL;
 	sink->put = file_put;
 	sink->put_cstr = generic_put_cstr;
+	sink->put_bytes = file_put_bytes;
+	sink->flush = file_flush;
+	sink->file = f;
+	sink->buf = NEWxN(char, SINK_BLOCK);
+	assert(sink->buf != NULL);
+	sink->count = 0;
+	sink->total = 0;
 	DBUG_RETURN sink;
 }
 
 static SINK* current_sink;
 
+static void
+flush_output()  /* DELIVER BUFFERED OUTPUT BEFORE WRITING DIRECTLY OR WAITING */
+{
+	if (current_sink != NULL) {
+		(current_sink->flush)(current_sink);
+	}
+}
+
+#define	SOURCE_BLOCK	4096	/* bytes read from a file at once */
+
 typedef struct source_t SOURCE;
 struct source_t {
 	CONS*		context;
 	CONS*		(*empty)(SOURCE*);  /* return a_true if empty, else a_false */
 	CONS*		(*get)(SOURCE*);  /* return value at current position */
 	CONS*		(*next)(SOURCE*);  /* return current and advance position */
+	int			(*fill)(SOURCE*);  /* refill buffer, return current char or EOF */
+	char*		cursor;		/* current position in buffered input */
+	char*		limit;		/* end of buffered input */
+	int			fd;			/* file descriptor (file sources only) */
+	char*		buf;		/* block buffer (file sources only) */
 };
 
+/*
+ * The lexer reads characters straight from the buffer through these
+ * macros, calling (fill) only when the buffer is exhausted.  The (empty),
+ * (get) and (next) functions remain as the general-purpose interface.
+ */
+#define	SOURCE_PEEK(src)	(((src)->cursor < (src)->limit) \
+		? (int)(unsigned char)*((src)->cursor) : ((src)->fill)(src))
+#define	SOURCE_SKIP(src)	(++((src)->cursor))  /* only after SOURCE_PEEK() != EOF */
+
 CONS*
-string_empty(SOURCE* src)
+source_empty(SOURCE* src)
 {
-	char* s;
-
-	DBUG_ENTER("string_empty");
-	s = (char*)(MK_PTR(src->context));
-	DBUG_PRINT("s", ((s ? "\"%s\"" : "NULL"), s));
-	DBUG_RETURN ((s && *s) ? a_false : a_true);
+	DBUG_ENTER("source_empty");
+	DBUG_RETURN ((SOURCE_PEEK(src) == EOF) ? a_true : a_false);
 }
 CONS*
-string_get(SOURCE* src)
+source_get(SOURCE* src)
 {
-	char* s;
 	int c;
 
-	DBUG_ENTER("string_get");
-	if ((src->empty)(src) == a_true) {
-		DBUG_PRINT("c", ("EOF"));
-		DBUG_RETURN NUMBER(EOF);
-	}
-	s = (char*)(MK_PTR(src->context));
-	c = *s;
+	DBUG_ENTER("source_get");
+	c = SOURCE_PEEK(src);
 	DBUG_PRINT("c", ((isprint(c) ? "%d '%c'" : "%d '\\x%X'"), c, c));
 	DBUG_RETURN NUMBER(c);
 }
 CONS*
-string_next(SOURCE* src)
+source_next(SOURCE* src)
 {
-	char* s;
-	CONS* c;
+	int c;
 
-	DBUG_ENTER("string_next");
-	c = (src->get)(src);
-	if (c == NUMBER(EOF)) {
-		DBUG_RETURN c;
+	DBUG_ENTER("source_next");
+	c = SOURCE_PEEK(src);
+	if (c != EOF) {
+		SOURCE_SKIP(src);
 	}
-	s = (char*)(MK_PTR(src->context));
-	src->context = MK_REF(++s);
-	DBUG_PRINT("s", ((s ? "\"%s\"" : "NULL"), s));
-	DBUG_RETURN c;
+	DBUG_PRINT("c", ((isprint(c) ? "%d '%c'" : "%d '\\x%X'"), c, c));
+	DBUG_RETURN NUMBER(c);
+}
+
+static int
+string_fill(SOURCE* src)
+{
+	return EOF;  /* the whole string is already buffered */
 }
 SOURCE*
 string_source(char* s)
@@ -208,64 +392,40 @@ string_source(char* s)
 	DBUG_ENTER("string_source");
 	DBUG_PRINT("s", ((s ? "\"%s\"" : "NULL"), s));
 	src = NEW(SOURCE);
-	src->context = MK_REF(s);
-	src->empty = string_empty;
-	src->get = string_get;
-	src->next = string_next;
+	src->context = NIL;
+	src->empty = source_empty;
+	src->get = source_get;
+	src->next = source_next;
+	src->fill = string_fill;
+	src->cursor = s;
+	src->limit = (s ? (s + strlen(s)) : s);
+	src->fd = -1;
+	src->buf = NULL;
 	DBUG_RETURN src;
 }
 
-CONS*
-file_empty(SOURCE* src)
-{
-	CONS* d;
-
-	DBUG_ENTER("file_empty");
-	d = (src->get)(src);
-	DBUG_RETURN ((d == NUMBER(EOF)) ? a_true : a_false);
-}
-CONS*
-file_get(SOURCE* src)
+static int
+file_fill(SOURCE* src)
 {
-	CONS* d;
-	int c;
+	ssize_t n;
 
-	DBUG_ENTER("file_get");
-	DBUG_PRINT("context", ("%s", cons_to_str(src->context)));
-	d = tl(src->context);
-	if (nilp(d)) {
-		(src->next)(src);
-		d = tl(src->context);
+	DBUG_ENTER("file_fill");
+	if (src->limit == NULL) {
+		DBUG_RETURN EOF;  /* end of input already seen */
 	}
-	c = MK_INT(d);
-	DBUG_PRINT("c", ((isprint(c) ? "%d '%c'" : "%d '\\x%X'"), c, c));
-	DBUG_RETURN d;
-}
-CONS*
-file_next(SOURCE* src)
-{
-	CONS* d;
-	FILE* f;
-
-	DBUG_ENTER("file_next");
-	d = tl(src->context);
-	if (d != NUMBER(EOF)) {
-		CONS* r = hd(src->context);
-		
-		XDBUG_PRINT("stdin", ("%p", stdin));
-		XDBUG_PRINT("input_file", ("%p", input_file));
-		if (r == MK_REF(input_file)) {
-			f = input_file;  /* FIXME: WORKAROUND FOR FILE* ENCODING */
-		} else {
-			f = (FILE*)(MK_PTR(r));
-		}
-		XDBUG_PRINT("f", ("%p", f));
-		rplacd(src->context, NUMBER(fgetc(f)));
+	n = read(src->fd, src->buf, SOURCE_BLOCK);
+	DBUG_PRINT("n", ("%ld", (long)n));
+	if (n <= 0) {
+		src->cursor = NULL;
+		src->limit = NULL;
+		DBUG_RETURN EOF;
 	}
-	DBUG_RETURN d;
+	src->cursor = src->buf;
+	src->limit = src->buf + n;
+	DBUG_RETURN (int)(unsigned char)*(src->cursor);
 }
 SOURCE*
-file_source(FILE* f)
+file_source(FILE* f)  /* WARNING! bypasses stdio buffering of f */
 {
 	SOURCE* src;
 
@@ -273,14 +433,31 @@ file_source(FILE* f)
 	assert(f != NULL);
 	DBUG_PRINT("f", ("%p", f));
 	src = NEW(SOURCE);
-	src->context = pr(MK_REF(f), NIL);
-	DBUG_PRINT("f'", ("%p", MK_PTR(hd(src->context))));
-	src->empty = file_empty;
-	src->get = file_get;
-	src->next = file_next;
-	DBUG_PRINT("context", ("%s", cons_to_str(src->context)));
+	assert(src != NULL);
+	src->context = NIL;
+	src->empty = source_empty;
+	src->get = source_get;
+	src->next = source_next;
+	src->fill = file_fill;
+	src->fd = fileno(f);
+	src->buf = NEWxN(char, SOURCE_BLOCK);
+	assert(src->buf != NULL);
+	src->cursor = src->buf;  /* empty, but not at end */
+	src->limit = src->buf;
 	DBUG_RETURN src;
 }
+SOURCE*
+free_source(SOURCE* src)  /* RELEASE src (BUT NOT ITS FILE OR STRING), RETURN NULL */
+{
+	DBUG_ENTER("free_source");
+	if (src != NULL) {
+		if (src->buf != NULL) {
+			FREE(src->buf);
+		}
+		FREE(src);
+	}
+	DBUG_RETURN NULL;
+}
 
 static SOURCE* current_source;
 
@@ -464,6 +641,26 @@ BEH_DECL(fork_beh)
 
 static BEH_DECL(cons_type);  /* forward */
 static BEH_DECL(pair_type);  /* forward */
+static BEH_DECL(env_type);  /* forward */
+static BEH_DECL(const_type);  /* forward */
+static BEH_DECL(bool_type);  /* forward */
+static BEH_DECL(null_type);  /* forward */
+static BEH_DECL(symbol_type);  /* forward */
+static BEH_DECL(any_type);  /* forward */
+static BEH_DECL(appl_type);  /* forward */
+static BEH_DECL(type_pred_oper);  /* forward */
+static BEH_DECL(cxr_oper);  /* forward */
+static CONS* env_lookup(CONS* env, CONS* key, CONS** next);  /* forward */
+static BEH_DECL(if_args_beh);  /* forward */
+
+static CONS*
+new_pair(CONS* head, CONS* tail)  /* CREATE IMMUTABLE PAIR, SHARED IF HASH-CONSING */
+{
+	if (hash_cons_pairs) {
+		return MK_ACTOR(hcons(MK_FUNC(pair_type), hcons(head, tail)));
+	}
+	return ACTOR(pair_type, pr(head, tail));
+}
 
 /**
 LET dotted_close_beh(cust) = \ok.[
@@ -517,7 +714,7 @@ BEH_DECL(dotted_tail_beh)
 	
 	if (ok == a_true) {
 		CONS* k_close = ACTOR(dotted_close_beh, cust);
-		SEND(last, pr(k_close, ATOM("write")));
+		SEND(last, pr(k_close, SEL(WRITE)));
 	} else {
 		SEND(cust, ok);
 	}
@@ -551,24 +748,30 @@ BEH_DECL(object_type)
 	ENSURE(actorp(cust));
 	req = tl(msg);
 
-	if (is_pr(req)
-	&& (hd(req) == ATOM("eval"))) {
+	switch (req_selector(req)) {
+	case SEL_EVAL:
 		SEND(cust, SELF);
+		break;
 /*
-	} else if (is_pr(req)
-	&& (hd(req) == ATOM("eq"))) {
+	case SEL_EQ:
 		SEND(cust, ((tl(req) == SELF) ? a_true : a_false));
+		break;
 */
-	} else if (req == ATOM("copy_immutable")) {
+	case SEL_COPY_IMMUTABLE:
 		SEND(cust, SELF);
-	} else if (is_pr(req)
-	&& (hd(req) == ATOM("write_tail"))
-	&& (tl(req) == NUMBER(' '))) {
-		SINK* sink = current_sink;
-		CONS* k_tail = ACTOR(dotted_tail_beh, pr(cust, SELF));
-		SEND(k_tail, (sink->put_cstr)(sink, " . "));
-	} else {
+		break;
+	case SEL_WRITE_TAIL:
+		if (tl(req) == NUMBER(' ')) {
+			SINK* sink = current_sink;
+			CONS* k_tail = ACTOR(dotted_tail_beh, pr(cust, SELF));
+			SEND(k_tail, (sink->put_cstr)(sink, " . "));
+		} else {
+			THROW(pr(ATOM("Not-Understood"), pr(SELF, req)));
+		}
+		break;
+	default:
 		THROW(pr(ATOM("Not-Understood"), pr(SELF, req)));
+		break;
 	}
 	DBUG_RETURN;
 }
@@ -598,14 +801,18 @@ BEH_DECL(unit_type)
 
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req)
-	&& (hd(req) == ATOM("type_eq"))) {
+	switch (req_selector(req)) {
+	case SEL_TYPE_EQ:
 		SEND(cust, ((tl(req) == MK_REF(unit_type)) ? a_true : a_false));
-	} else if (req == ATOM("write")) {
+		break;
+	case SEL_WRITE: {
 		SINK* sink = current_sink;
 		SEND(cust, (sink->put_cstr)(sink, "#inert"));
-	} else {
+		break;
+	}
+	default:
 		object_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
 	}
 	DBUG_RETURN;
 }
@@ -635,14 +842,18 @@ BEH_DECL(oper_type)
 
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req)
-	&& (hd(req) == ATOM("type_eq"))) {
+	switch (req_selector(req)) {
+	case SEL_TYPE_EQ:
 		SEND(cust, ((tl(req) == MK_REF(oper_type)) ? a_true : a_false));
-	} else if (req == ATOM("write")) {
+		break;
+	case SEL_WRITE: {
 		SINK* sink = current_sink;
 		SEND(cust, (sink->put_cstr)(sink, "#operative"));
-	} else {
+		break;
+	}
+	default:
 		object_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
 	}
 	DBUG_RETURN;
 }
@@ -674,16 +885,19 @@ BEH_DECL(args_oper)
 
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req) && is_pr(tl(req))
-	&& (hd(req) == ATOM("comb"))) {
+	switch (req_selector(req)) {
+	case SEL_COMB: {
 		CONS* opnds = hd(tl(req));
 		CONS* env = tl(tl(req));
 		CONS* k_args;
 
 		k_args = ACTOR((MK_BEH(args_beh)), pr(cust, env));
-		SEND(opnds, pr(k_args, ATOM("as_tuple")));
-	} else {
+		SEND(opnds, pr(k_args, SEL(AS_TUPLE)));
+		break;
+	}
+	default:
 		oper_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
 	}
 	DBUG_RETURN;
 }
@@ -711,15 +925,135 @@ BEH_DECL(appl_args_beh)
 	comb = hd(tl(state));
 	env = tl(tl(state));
 	expr = ACTOR(pair_type, pr(comb, args));
-	SEND(expr, pr(cust, pr(ATOM("eval"), env)));
+	SEND(expr, pr(cust, pr(SEL(EVAL), env)));
 	DBUG_RETURN;
 }
+/*
+ * Operands that are constants, or symbols bound in a chain of env_type
+ * actors, can be evaluated synchronously instead of by #map.  When all
+ * of them can, an applicative applies its combiner to the values
+ * directly.  Primitive (args_oper), type-predicate and accessor (cxr_oper)
+ * combiners then finish without any further actor round-trips.  Evaluating such
+ * operands has no effects, so any other case falls back to #map.
+ */
+static CONS*
+appl_fast_args(CONS* opnds, CONS* env)  /* REVERSED ARG VALUES, OR NULL */
+{
+	CONS* args = NIL;
+	CONS* opnd;
+	CONS* binding;
+	CONS* next;
+	BEH beh;
+
+	for (;;) {
+		if (!actorp(opnds)) {
+			return NULL;
+		}
+		beh = _THIS(opnds);
+		if (beh == null_type) {
+			return args;
+		}
+		if ((beh != pair_type) && (beh != cons_type)) {
+			return NULL;  /* dotted operand list */
+		}
+		opnd = hd(_MINE(opnds));
+		if (!actorp(opnd)) {
+			return NULL;
+		}
+		beh = _THIS(opnd);
+		if (beh == symbol_type) {
+			if (!actorp(env) || (_THIS(env) != env_type)) {
+				return NULL;
+			}
+			binding = env_lookup(env, _MINE(opnd), &next);
+			if (nilp(binding)) {
+				return NULL;  /* let #lookup forward or throw */
+			}
+			args = pr(tl(binding), args);
+		} else if ((beh == const_type) || (beh == bool_type)
+		|| (beh == unit_type) || (beh == null_type) || (beh == any_type)) {
+			args = pr(opnd, args);
+		} else {
+			return NULL;  /* nested combination, etc. */
+		}
+		opnds = tl(_MINE(opnds));
+	}
+}
+
+static BEH
+appl_type_of(CONS* value)  /* BEHAVIOR ANSWERING #type_eq, OR NULL IF UNKNOWN */
+{
+	BEH beh = _THIS(value);
+
+	if ((beh == const_type) || (beh == bool_type) || (beh == unit_type)
+	|| (beh == null_type) || (beh == symbol_type) || (beh == any_type)
+	|| (beh == env_type) || (beh == appl_type)) {
+		return beh;
+	}
+	if ((beh == pair_type) || (beh == cons_type)) {
+		return pair_type;
+	}
+	return NULL;
+}
+
+static CONS*
+appl_fast_pred(CONS* args, CONS* type)  /* Boolean ACTOR, OR NULL IF UNKNOWN */
+{
+	CONS* result = a_true;
+	BEH beh;
+
+	while (!nilp(args)) {
+		beh = appl_type_of(hd(args));
+		if (beh == NULL) {
+			return NULL;
+		}
+		if (MK_REF(beh) != type) {
+			result = a_false;
+		}
+		args = tl(args);
+	}
+	return result;
+}
+
+static BOOL
+pair_valuep(CONS* value)  /* IMMUTABLE OR MUTABLE PAIR? */
+{
+	return ((actorp(value)
+		&& ((_THIS(value) == pair_type) || (_THIS(value) == cons_type))) ? TRUE : FALSE);
+}
+
+static CONS*
+cxr_path(CONS* path, CONS* value)  /* FOLLOW path FROM value, OR NULL IF NOT PAIRS */
+{
+	int n;
+
+	for (n = MK_INT(path); n > 1; n >>= 1) {  /* low bit: 0=car, 1=cdr */
+		if (!pair_valuep(value)) {
+			return NULL;
+		}
+		value = ((n & 1) ? tl(_MINE(value)) : hd(_MINE(value)));
+	}
+	return value;
+}
+
+static CONS*
+appl_fast_call(CONS* comb, CONS* args)  /* RESULT OF A SYNCHRONOUS PRIMITIVE, OR NULL */
+{
+	if (_THIS(comb) == type_pred_oper) {
+		return appl_fast_pred(args, _MINE(comb));
+	}
+	if ((_THIS(comb) == cxr_oper) && is_pr(args) && nilp(tl(args))) {
+		return cxr_path(_MINE(comb), hd(args));
+	}
+	return NULL;
+}
+
 /**
 LET appl_type(comb) = \(cust, req).[
 	CASE req OF
 	(#type_eq, $appl_type) : [ SEND True TO cust ]
 	(#type_eq, _) : [ SEND False TO cust ]
-	(#comb, opnds, env) : [
+	(#comb, opnds, env) : [  # fast path when appl_fast_args(opnds, env) succeeds
 		SEND (k_args, #map, #eval, env) TO opnds
 		CREATE k_args WITH \args.[  # appl_args_beh
 			CREATE expr WITH Pair(comb, args)
@@ -749,23 +1083,47 @@ BEH_DECL(appl_type)
 
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req)
-	&& (hd(req) == ATOM("type_eq"))) {
+	switch (req_selector(req)) {
+	case SEL_TYPE_EQ:
 		SEND(cust, ((tl(req) == MK_REF(appl_type)) ? a_true : a_false));
-	} else if (is_pr(req) && is_pr(tl(req))
-	&& (hd(req) == ATOM("comb"))) {
+		break;
+	case SEL_COMB: {
 		CONS* opnds = hd(tl(req));
 		CONS* env = tl(tl(req));
-		CONS* k_args = ACTOR(appl_args_beh, pr(cust, pr(comb, env)));
+		CONS* args = appl_fast_args(opnds, env);
+		CONS* value;
+
+		if (args == NULL) {
+			CONS* k_args = ACTOR(appl_args_beh, pr(cust, pr(comb, env)));
+
+			SEND(opnds, pr(k_args, pr(SEL(MAP), pr(SEL(EVAL), env))));
+		} else if (_THIS(comb) == args_oper) {
+			CONS* k_args = ACTOR(MK_BEH(_MINE(comb)), pr(cust, env));
 
-		SEND(opnds, pr(k_args, pr(ATOM("map"), pr(ATOM("eval"), env))));
-	} else if (req == ATOM("unwrap")) {
+			SEND(k_args, reverse(args));
+		} else if ((value = appl_fast_call(comb, args)) != NULL) {
+			SEND(cust, value);
+		} else {
+			CONS* list = a_nil;
+
+			for (; !nilp(args); args = tl(args)) {
+				list = new_pair(hd(args), list);
+			}
+			SEND(comb, pr(cust, pr(SEL(COMB), pr(list, env))));
+		}
+		break;
+	}
+	case SEL_UNWRAP:
 		SEND(cust, comb);
-	} else if (req == ATOM("write")) {
+		break;
+	case SEL_WRITE: {
 		SINK* sink = current_sink;
 		SEND(cust, (sink->put_cstr)(sink, "#applicative"));
-	} else {
+		break;
+	}
+	default:
 		object_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
 	}
 	DBUG_RETURN;
 }
@@ -799,22 +1157,44 @@ BEH_DECL(const_type)  /* FIXME: extend to implement encapsulation types */
 	DBUG_PRINT("value", ("%s", cons_to_str(value)));
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req)
-	&& (hd(req) == ATOM("type_eq"))) {
+	switch (req_selector(req)) {
+	case SEL_TYPE_EQ:
 		SEND(cust, ((tl(req) == MK_REF(const_type)) ? a_true : a_false));
-	} else if (req == ATOM("value")) {
+		break;
+	case SEL_VALUE:
 		SEND(cust, value);
-	} else if (req == ATOM("write")) {
+		break;
+	case SEL_WRITE: {
 		SINK* sink = current_sink;
 		char* s = printable(value);
 		SEND(cust, (sink->put_cstr)(sink, s));
 		FREE(s);
-	} else {
+		break;
+	}
+	default:
 		object_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
 	}
 	DBUG_RETURN;
 }
 
+static void
+intern_reindex()  /* REBUILD intern_index FROM intern_map */
+{
+	CONS* p;
+
+	if (intern_index == NULL) {
+		intern_index = new_htab(0);
+	}
+	clear_htab(intern_index);
+	for (p = car(intern_map); !nilp(p); p = cdr(p)) {
+		htab_put(intern_index, car(car(p)), MK_REF(const_type), cdr(car(p)));
+	}
+	for (p = cdr(intern_map); !nilp(p); p = cdr(p)) {
+		htab_put(intern_index, car(car(p)), MK_REF(symbol_type), cdr(car(p)));
+	}
+}
+
 static CONS*
 get_const(CONS* value)  /* USE FACTORY TO INTERN INSTANCES */
 {
@@ -823,11 +1203,12 @@ get_const(CONS* value)  /* USE FACTORY TO INTERN INSTANCES */
 
 	DBUG_ENTER("get_const");
 	DBUG_PRINT("value", ("%s", cons_to_str(value)));
-	constant = map_get_def(const_map, value, NIL);
+	constant = htab_get(intern_index, value, MK_REF(const_type), NIL);
 	if (nilp(constant)) {
 		constant = ACTOR(const_type, value);
 		const_map = map_put(const_map, value, constant);
 		rplaca(intern_map, const_map);
+		htab_put(intern_index, value, MK_REF(const_type), constant);
 	}
 	DBUG_PRINT("const", ("%s", cons_to_str(constant)));
 	DBUG_RETURN constant;
@@ -871,21 +1252,26 @@ BEH_DECL(bool_type)
 	DBUG_PRINT("value", ("%s", cons_to_str(value)));
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req)
-	&& (hd(req) == ATOM("type_eq"))) {
+	switch (req_selector(req)) {
+	case SEL_TYPE_EQ:
 		SEND(cust, ((tl(req) == MK_REF(bool_type)) ? a_true : a_false));
-	} else if (is_pr(req) && is_pr(tl(req)) && is_pr(tl(tl(req)))
-	&& (hd(req) == ATOM("if"))) {
+		break;
+	case SEL_IF: {
 		CONS* cnsq = hd(tl(req));
 		CONS* altn = hd(tl(tl(req)));
 		CONS* env = tl(tl(tl(req)));
 
-		SEND((value ? cnsq : altn), pr(cust, pr(ATOM("eval"), env)));
-	} else if (req == ATOM("write")) {
+		SEND((value ? cnsq : altn), pr(cust, pr(SEL(EVAL), env)));
+		break;
+	}
+	case SEL_WRITE: {
 		SINK* sink = current_sink;
 		SEND(cust, (sink->put_cstr)(sink, (value ? "#t" : "#f")));
-	} else {
+		break;
+	}
+	default:
 		object_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
 	}
 	DBUG_RETURN;
 }
@@ -925,16 +1311,69 @@ BEH_DECL(type_pred_oper)
 
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req) && is_pr(tl(req))
-	&& (hd(req) == ATOM("comb"))) {
+	switch (req_selector(req)) {
+	case SEL_COMB: {
 		CONS* opnds = hd(tl(req));
 		/* CONS* env = tl(tl(req)); */
 
-		SEND(opnds, pr(cust, pr(ATOM("foldl"),
+		SEND(opnds, pr(cust, pr(SEL(FOLDL),
 			pr(a_true, pr(MK_FUNC(boolean_and),
-			pr(ATOM("type_eq"), type))))));
-	} else {
+			pr(SEL(TYPE_EQ), type))))));
+		break;
+	}
+	default:
+		oper_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
+	}
+	DBUG_RETURN;
+}
+
+/**
+LET cxr_oper(path) = \(cust, req).[
+	CASE req OF
+	(#comb, (value), env) : [  # car, cdr, cadr, ... cddddr
+		SEND cxr_path(path, value) TO cust
+	]
+	_ : oper_type(cust, req)
+	END
+]
+**/
+static
+BEH_DECL(cxr_oper)
+{
+	CONS* path = MINE;
+	CONS* msg = WHAT;
+	CONS* cust;
+	CONS* req;
+
+	DBUG_ENTER("cxr_oper");
+	ENSURE(numberp(path));
+	ENSURE(is_pr(msg));
+	cust = hd(msg);
+	ENSURE(actorp(cust));
+	req = tl(msg);
+
+	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
+	DBUG_PRINT("req", ("%s", cons_to_str(req)));
+	switch (req_selector(req)) {
+	case SEL_COMB: {
+		CONS* opnds = hd(tl(req));
+		CONS* value = NULL;
+
+		if (pair_valuep(opnds)
+		&& actorp(tl(_MINE(opnds))) && (_THIS(tl(_MINE(opnds))) == null_type)) {
+			value = cxr_path(path, hd(_MINE(opnds)));
+		}
+		if (value == NULL) {
+			THROW(pr(ATOM("Not-Understood"), pr(SELF, req)));
+		} else {
+			SEND(cust, value);
+		}
+		break;
+	}
+	default:
 		oper_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
 	}
 	DBUG_RETURN;
 }
@@ -972,42 +1411,57 @@ BEH_DECL(null_type)
 
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req)
-	&& (hd(req) == ATOM("type_eq"))) {
+	switch (req_selector(req)) {
+	case SEL_TYPE_EQ:
 		SEND(cust, ((tl(req) == MK_REF(null_type)) ? a_true : a_false));
-	} else if (is_pr(req)
-	&& (hd(req) == ATOM("eval"))) {
+		break;
+	case SEL_EVAL:
 		SEND(cust, SELF);
-	} else if (req == ATOM("as_pair")) {
+		break;
+	case SEL_AS_PAIR:
 		SEND(cust, NIL);
-	} else if (req == ATOM("as_tuple")) {
+		break;
+	case SEL_AS_TUPLE:
 		SEND(cust, NIL);
-	} else if (is_pr(req) && is_pr(tl(req))
-	&& (hd(req) == ATOM("match"))
-	&& (hd(tl(req)) == a_nil)) {
-		SEND(cust, a_inert);
-	} else if (req == ATOM("copy_immutable")) {
+		break;
+	case SEL_MATCH:
+		if (hd(tl(req)) == a_nil) {
+			SEND(cust, a_inert);
+		} else {
+			THROW(pr(ATOM("Not-Understood"), pr(SELF, req)));
+		}
+		break;
+	case SEL_COPY_IMMUTABLE:
 		SEND(cust, SELF);
-	} else if (is_pr(req)
-	&& (hd(req) == ATOM("map"))) {
+		break;
+	case SEL_MAP: {
 		CONS* req_ = tl(req);
 
 		SEND(SELF, pr(cust, req_));
-	} else if (is_pr(req) && is_pr(tl(req))
-	&& (hd(req) == ATOM("foldl"))) {
+		break;
+	}
+	case SEL_FOLDL: {
 		CONS* zero = hd(tl(req));
 
 		SEND(cust, zero);
-	} else if (req == ATOM("write")) {
+		break;
+	}
+	case SEL_WRITE: {
 		SINK* sink = current_sink;
 		SEND(cust, (sink->put_cstr)(sink, "()"));
-	} else if (is_pr(req)
-	&& (hd(req) == ATOM("write_tail"))
-	&& (tl(req) == NUMBER(' '))) {
-		SINK* sink = current_sink;
-		SEND(cust, (sink->put)(sink, NUMBER(')')));
-	} else {
+		break;
+	}
+	case SEL_WRITE_TAIL:
+		if (tl(req) == NUMBER(' ')) {
+			SINK* sink = current_sink;
+			SEND(cust, (sink->put)(sink, NUMBER(')')));
+		} else {
+			THROW(pr(ATOM("Not-Understood"), pr(SELF, req)));
+		}
+		break;
+	default:
 		THROW(pr(ATOM("Not-Understood"), pr(SELF, req)));
+		break;
 	}
 	DBUG_RETURN;
 }
@@ -1035,9 +1489,9 @@ BEH_DECL(pair_comb_beh)
 	ENSURE(is_pr(tl(state)));
 	right = hd(tl(state));
 	env = tl(tl(state));
-	SEND(cust, pr(cust, pr(ATOM("comb"), pr(right, env))));
+	SEND(cust, pr(cust, pr(SEL(COMB), pr(right, env))));
 */
-	SEND(comb, pr(cust, pr(ATOM("comb"), tl(state))));
+	SEND(comb, pr(cust, pr(SEL(COMB), tl(state))));
 	DBUG_RETURN;
 }
 /**
@@ -1099,7 +1553,7 @@ BEH_DECL(pair_copy_beh)
 	DBUG_ENTER("pair_copy_beh");
 	ENSURE(actorp(cust));
 	if (is_pr(head_tail)) {
-		SEND(cust, ACTOR(pair_type, head_tail));  /* immutable */
+		SEND(cust, new_pair(hd(head_tail), tl(head_tail)));  /* immutable */
 	}
 	DBUG_RETURN;
 }
@@ -1154,7 +1608,7 @@ BEH_DECL(pair_foldl_beh)
 	req_ = tl(tl(tl(tl(state))));
 
 	value = ((LAMBDA_x_y)MK_BEH(oplus))(zero, one);
-	SEND(right, pr(cust, pr(ATOM("foldl"), pr(value, pr(oplus, req_)))));
+	SEND(right, pr(cust, pr(SEL(FOLDL), pr(value, pr(oplus, req_)))));
 	DBUG_RETURN;
 }
 /**
@@ -1181,7 +1635,7 @@ BEH_DECL(pair_write_tail_beh)
 	ENSURE(actorp(right));
 
 	if (ok == a_true) {
-		SEND(right, pr(cust, pr(ATOM("write_tail"), NUMBER(' '))));
+		SEND(right, pr(cust, pr(SEL(WRITE_TAIL), NUMBER(' '))));
 	} else {
 		SEND(cust, ok);  /* failure */
 	}
@@ -1293,85 +1747,100 @@ BEH_DECL(cons_type)
 	DBUG_PRINT("right", ("%s", cons_to_str(right)));
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req)
-	&& (hd(req) == ATOM("type_eq"))) {
+	switch (req_selector(req)) {
+	case SEL_TYPE_EQ:
 		SEND(cust, ((tl(req) == MK_REF(pair_type)) ? a_true : a_false));
-	} else if (is_pr(req)
-	&& (hd(req) == ATOM("eval"))) {
+		break;
+	case SEL_EVAL: {
 		CONS* env = tl(req);
 		CONS* k_comb = ACTOR(pair_comb_beh, pr(cust, pr(right, env)));
 
-		SEND(left, pr(k_comb, pr(ATOM("eval"), env)));
-	} else if (req == ATOM("as_pair")) {
+		SEND(left, pr(k_comb, pr(SEL(EVAL), env)));
+		break;
+	}
+	case SEL_AS_PAIR:
 		SEND(cust, state);
-	} else if (req == ATOM("as_tuple")) {
+		break;
+	case SEL_AS_TUPLE: {
 		CONS* k_tuple = ACTOR(pair_tuple_beh, pr(cust, left));
 
-		SEND(right, pr(k_tuple, ATOM("as_tuple")));
-	} else if (is_pr(req) && is_pr(tl(req))
-	&& (hd(req) == ATOM("match"))) {
+		SEND(right, pr(k_tuple, SEL(AS_TUPLE)));
+		break;
+	}
+	case SEL_MATCH: {
 		CONS* value = hd(tl(req));
 		CONS* env = tl(tl(req));
 		CONS* k_pair = ACTOR(pair_match_beh, cust);
 		CONS* fork = ACTOR(fork_beh, pr(k_pair, pr(value, value)));
 
 		SEND(fork, pr(
-			pr(ATOM("left_match"), pr(left, env)),
-			pr(ATOM("right_match"), pr(right, env))));
-	} else if (is_pr(req) && is_pr(tl(req))
-	&& (hd(req) == ATOM("left_match"))) {
+			pr(SEL(LEFT_MATCH), pr(left, env)),
+			pr(SEL(RIGHT_MATCH), pr(right, env))));
+		break;
+	}
+	case SEL_LEFT_MATCH: {
 		CONS* ptree = hd(tl(req));
 		CONS* env = tl(tl(req));
 
-		SEND(ptree, pr(cust, pr(ATOM("match"), pr(left, env))));
-	} else if (is_pr(req) && is_pr(tl(req))
-	&& (hd(req) == ATOM("right_match"))) {
+		SEND(ptree, pr(cust, pr(SEL(MATCH), pr(left, env))));
+		break;
+	}
+	case SEL_RIGHT_MATCH: {
 		CONS* ptree = hd(tl(req));
 		CONS* env = tl(tl(req));
 
-		SEND(ptree, pr(cust, pr(ATOM("match"), pr(right, env))));
-	} else if (req == ATOM("copy_immutable")) {
+		SEND(ptree, pr(cust, pr(SEL(MATCH), pr(right, env))));
+		break;
+	}
+	case SEL_COPY_IMMUTABLE: {
 		CONS* k_pair = ACTOR(pair_copy_beh, cust);
 		CONS* fork = ACTOR(fork_beh, pr(k_pair, pr(left, right)));
 
 		SEND(fork, pr(req, req));
-	} else if (is_pr(req)
-	&& (hd(req) == ATOM("map"))) {
+		break;
+	}
+	case SEL_MAP: {
 		CONS* req_ = tl(req);
 		CONS* k_pair = ACTOR(pair_map_beh, cust);
 		CONS* fork = ACTOR(fork_beh, pr(k_pair, pr(left, right)));
 
 		SEND(fork, pr(req_, req));
-	} else if (is_pr(req) && is_pr(tl(req)) && is_pr(tl(tl(req)))
-	&& (hd(req) == ATOM("foldl"))) {
+		break;
+	}
+	case SEL_FOLDL: {
 		CONS* req_ = tl(tl(tl(req)));
 		CONS* k_one = ACTOR(pair_foldl_beh, pr(cust, pr(right, tl(req))));
 
 		SEND(left, pr(k_one, req_));
-	} else if (is_pr(req)
-	&& (hd(req) == ATOM("set_car"))) {
+		break;
+	}
+	case SEL_SET_CAR:
 		BECOME(THIS, pr(tl(req), right));
 		SEND(cust, a_inert);
-	} else if (is_pr(req)
-	&& (hd(req) == ATOM("set_cdr"))) {
+		break;
+	case SEL_SET_CDR:
 		BECOME(THIS, pr(left, tl(req)));
 		SEND(cust, a_inert);
-	} else if (req == ATOM("write")) {
-		SEND(SELF, pr(cust, pr(ATOM("write_tail"), NUMBER('('))));
-	} else if (is_pr(req)
-	&& (hd(req) == ATOM("write_tail"))) {
+		break;
+	case SEL_WRITE:
+		SEND(SELF, pr(cust, pr(SEL(WRITE_TAIL), NUMBER('('))));
+		break;
+	case SEL_WRITE_TAIL: {
 		CONS* prefix = tl(req);
 		CONS* k_write;
 		SINK* sink = current_sink;
 
 		if ((sink->put)(sink, prefix) == a_true) {
 			k_write = ACTOR(pair_write_tail_beh, pr(cust, right));
-			SEND(left, pr(k_write, ATOM("write")));
+			SEND(left, pr(k_write, SEL(WRITE)));
 		} else {
 			SEND(cust, a_false);
 		}
-	} else {
+		break;
+	}
+	default:
 		THROW(pr(ATOM("Not-Understood"), pr(SELF, req)));
+		break;
 	}
 	DBUG_RETURN;
 }
@@ -1400,16 +1869,19 @@ BEH_DECL(pair_type)
 
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req)
-	&& (hd(req) == ATOM("set_car"))) {
+	switch (req_selector(req)) {
+	case SEL_SET_CAR:
 		THROW(pr(ATOM("Immutable"), SELF));
-	} else if (is_pr(req)
-	&& (hd(req) == ATOM("set_cdr"))) {
+		break;
+	case SEL_SET_CDR:
 		THROW(pr(ATOM("Immutable"), SELF));
-	} else if (req == ATOM("copy_immutable")) {
+		break;
+	case SEL_COPY_IMMUTABLE:
 		SEND(cust, SELF);
-	} else {
+		break;
+	default:
 		cons_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
 	}
 	DBUG_RETURN;
 }
@@ -1443,27 +1915,33 @@ BEH_DECL(symbol_type)
 	DBUG_PRINT("name", ("%s", cons_to_str(name)));
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req)
-	&& (hd(req) == ATOM("type_eq"))) {
+	switch (req_selector(req)) {
+	case SEL_TYPE_EQ:
 		SEND(cust, ((tl(req) == MK_REF(symbol_type)) ? a_true : a_false));
-	} else if (is_pr(req)
-	&& (hd(req) == ATOM("eval"))) {
+		break;
+	case SEL_EVAL: {
 		CONS* env = tl(req);
 
-		SEND(env, pr(cust, pr(ATOM("lookup"), name)));
-	} else if (is_pr(req) && is_pr(tl(req))
-	&& (hd(req) == ATOM("match"))) {
+		SEND(env, pr(cust, pr(SEL(LOOKUP), name)));
+		break;
+	}
+	case SEL_MATCH: {
 		CONS* value = hd(tl(req));
 		CONS* env = tl(tl(req));
 
-		SEND(env, pr(cust, pr(ATOM("bind"), pr(name, value))));
-	} else if (req == ATOM("write")) {
+		SEND(env, pr(cust, pr(SEL(BIND), pr(name, value))));
+		break;
+	}
+	case SEL_WRITE: {
 		SINK* sink = current_sink;
 		char* s = printable(name);
 		SEND(cust, (sink->put_cstr)(sink, s));
 		FREE(s);
-	} else {
+		break;
+	}
+	default:
 		object_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
 	}
 	DBUG_RETURN;
 }
@@ -1476,11 +1954,12 @@ get_symbol(CONS* name)  /* USE FACTORY TO INTERN INSTANCES */
 
 	DBUG_ENTER("get_symbol");
 	DBUG_PRINT("name", ("%s", cons_to_str(name)));
-	symbol = map_get_def(symbol_map, name, NIL);
+	symbol = htab_get(intern_index, name, MK_REF(symbol_type), NIL);
 	if (nilp(symbol)) {
 		symbol = ACTOR(symbol_type, name);
 		symbol_map = map_put(symbol_map, name, symbol);
 		rplacd(intern_map, symbol_map);
+		htab_put(intern_index, name, MK_REF(symbol_type), symbol);
 	}
 	DBUG_PRINT("symbol", ("%s", cons_to_str(symbol)));
 	DBUG_RETURN symbol;
@@ -1512,40 +1991,156 @@ BEH_DECL(any_type)
 
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req)
-	&& (hd(req) == ATOM("type_eq"))) {
+	switch (req_selector(req)) {
+	case SEL_TYPE_EQ:
 		SEND(cust, ((tl(req) == MK_REF(any_type)) ? a_true : a_false));
-	} else if (is_pr(req)
-	&& (hd(req) == ATOM("match"))) {
+		break;
+	case SEL_MATCH:
 		SEND(cust, a_inert);
-	} else if (req == ATOM("write")) {
+		break;
+	case SEL_WRITE: {
 		SINK* sink = current_sink;
 		SEND(cust, (sink->put_cstr)(sink, "#ignore"));
-	} else {
+		break;
+	}
+	default:
 		object_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
 	}
 	DBUG_RETURN;
 }
 
-/**
-LET env_type(parent, map) = \(cust, req).[
+/*
+ * Environments with more than ENV_HASH_MIN bindings are indexed in
+ * env_index, keyed on (env, symbol).  Lookups walk the chain of
+ * env_type ancestors synchronously (the state of an env_type actor
+ * only changes by BECOME within env_type itself), so resolving a name
+ * takes one message no matter how deeply frames are nested.  Names
+ * resolved from the ground environment are also cached, and the cache
+ * entry is dropped when a new binding for that name is made anywhere
+ * on the ground environment chain.  Re-binding an existing name
+ * updates the binding in place, so cached bindings remain valid.
+ */
+#define	ENV_HASH_MIN	16  /* bindings before an environment is indexed */
+
+static HTAB* env_index = NULL;  /* (env, symbol)->binding, (env, NULL)->env if indexed */
+static HTAB* ground_cache = NULL;  /* (symbol, ground env)->binding */
+
+static void
+env_sweep()  /* DROP INDEX ENTRIES FOR COLLECTED ENVIRONMENTS */
+{
+	htab_prune(env_index, gc_garbagep);
+	htab_prune(ground_cache, gc_garbagep);
+}
+
+static void
+init_env_index()
+{
+	env_index = new_htab(0);
+	ground_cache = new_htab(0);
+	gc_add_weak_hook(env_sweep);
+}
+
+static CONS*
+env_find(CONS* env, CONS* map, CONS* key)  /* FIND BINDING FOR key IN env ALONE */
+{
+	CONS* p;
+	int n = 0;
+
+	if (htab_get(env_index, env, NULL, NULL) != NULL) {
+		return htab_get(env_index, env, key, NIL);
+	}
+	for (p = map; !nilp(p); p = tl(p)) {
+		if (hd(hd(p)) == key) {
+			return hd(p);
+		}
+		if (++n > ENV_HASH_MIN) {  /* large environment, index it */
+			for (p = map; !nilp(p); p = tl(p)) {
+				if (htab_get(env_index, env, hd(hd(p)), NULL) == NULL) {
+					htab_put(env_index, env, hd(hd(p)), hd(p));
+				}
+			}
+			htab_put(env_index, env, NULL, env);
+			return htab_get(env_index, env, key, NIL);
+		}
+	}
+	return NIL;
+}
+
+static CONS*
+env_lookup(CONS* env, CONS* key, CONS** next)  /* FIND BINDING FOR key IN CHAIN FROM env */
+{
+	CONS* ground = NIL;
+	CONS* binding;
+	CONS* state;
+
+	*next = NIL;
+	for (;;) {
+		if (env == a_ground_env) {
+			binding = htab_get(ground_cache, key, env, NIL);
+			if (!nilp(binding)) {
+				return binding;
+			}
+			ground = env;
+		}
+		state = _MINE(env);
+		binding = env_find(env, tl(state), key);
+		if (!nilp(binding)) {
+			break;
+		}
+		env = hd(state);
+		if (nilp(env)) {
+			return NIL;  /* undefined */
+		}
+		if (_THIS(env) != env_type) {
+			*next = env;  /* continue search by message */
+			return NIL;
+		}
+	}
+	if (!nilp(ground)) {
+		htab_put(ground_cache, key, ground, binding);
+	}
+	return binding;
+}
+
+static void
+env_bound(CONS* env, CONS* binding)  /* RECORD NEW binding IN env */
+{
+	CONS* p;
+
+	if (htab_get(env_index, env, NULL, NULL) != NULL) {
+		htab_put(env_index, env, hd(binding), binding);
+	}
+	for (p = a_ground_env; actorp(p) && (_THIS(p) == env_type); p = hd(_MINE(p))) {
+		if (p == env) {  /* may shadow a cached binding */
+			htab_remove(ground_cache, hd(binding), a_ground_env);
+			break;
+		}
+	}
+}
+
+/**
+LET env_type(parent, map) = \(cust, req).[
 	CASE req OF
 	(#type_eq, $unit_type) : [ SEND True TO cust ]
 	(#type_eq, _) : [ SEND False TO cust ]
 	(#lookup, key) : [
-		CASE map_find(map, key) OF
+		CASE env_lookup(SELF, key) OF  # search env_type ancestors
 		NIL : [
-			CASE parent OF
+			CASE next OF  # first non-env_type ancestor
 			NIL : [ THROW (#Undefined, key) ]
-			_ : [ SEND (cust, req) TO parent ]
+			_ : [ SEND (cust, req) TO next ]
 			END
 		]
 		(_, value) : [ SEND value TO cust ]
 		END
 	]
 	(#bind, key, value) : [
-		CASE map_find(map, key) OF
-		NIL : [ BECOME env_type(parent, map_put(map, key, value)) ]
+		CASE env_find(SELF, key) OF
+		NIL : [
+			BECOME env_type(parent, map_put(map, key, value))
+			env_bound(SELF, (key, value))
+		]
 		binding : rplacd(binding, value)
 		END
 		SEND Inert TO cust  # new binding
@@ -1578,45 +2173,54 @@ BEH_DECL(env_type)
 	DBUG_PRINT("map", ("%s", cons_to_str(map)));
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req)
-	&& (hd(req) == ATOM("type_eq"))) {
+	switch (req_selector(req)) {
+	case SEL_TYPE_EQ:
 		SEND(cust, ((tl(req) == MK_REF(env_type)) ? a_true : a_false));
-	} else if (is_pr(req)
-	&& (hd(req) == ATOM("lookup"))) {
+		break;
+	case SEL_LOOKUP: {
 		CONS* key = tl(req);
-		CONS* binding = map_find(map, key);
+		CONS* next;
+		CONS* binding = env_lookup(SELF, key, &next);
 
 		DBUG_PRINT("key", ("%s", cons_to_str(key)));
 		DBUG_PRINT("binding", ("%s", cons_to_str(binding)));
 		if (nilp(binding)) {
-			if (nilp(parent)) {
+			if (nilp(next)) {
 				THROW(pr(ATOM("Undefined"), key));
 			} else {
-				SEND(parent, msg);
+				SEND(next, msg);
 			}
 		} else {
 			SEND(cust, tl(binding));
 		}
-	} else if (is_pr(req) && is_pr(tl(req))
-	&& (hd(req) == ATOM("bind"))) {
+		break;
+	}
+	case SEL_BIND: {
 		CONS* key = hd(tl(req));
 		CONS* value = tl(tl(req));
-		CONS* binding = map_find(map, key);
+		CONS* binding = env_find(SELF, map, key);
 
 		DBUG_PRINT("key", ("%s", cons_to_str(key)));
 		DBUG_PRINT("value", ("%s", cons_to_str(value)));
 		DBUG_PRINT("binding", ("%s", cons_to_str(binding)));
 		if (nilp(binding)) {
-			BECOME(env_type, pr(parent, map_put(map, key, value)));
+			map = map_put(map, key, value);
+			BECOME(env_type, pr(parent, map));
+			env_bound(SELF, hd(map));
 		} else {
 			rplacd(binding, value);
 		}
 		SEND(cust, a_inert);
-	} else if (req == ATOM("write")) {
+		break;
+	}
+	case SEL_WRITE: {
 		SINK* sink = current_sink;
 		SEND(cust, (sink->put_cstr)(sink, "#environment"));
-	} else {
+		break;
+	}
+	default:
 		object_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
 	}
 	DBUG_RETURN;
 }
@@ -1676,14 +2280,17 @@ BEH_DECL(list_oper)
 
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req) && is_pr(tl(req))
-	&& (hd(req) == ATOM("comb"))) {
+	switch (req_selector(req)) {
+	case SEL_COMB: {
 		CONS* opnds = hd(tl(req));
 		/* CONS* env = tl(tl(req)); */
 
 		SEND(cust, opnds);
-	} else {
+		break;
+	}
+	default:
 		oper_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
 	}
 	DBUG_RETURN;
 }
@@ -1721,15 +2328,18 @@ BEH_DECL(sequence_oper)
 
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req) && is_pr(tl(req))
-	&& (hd(req) == ATOM("comb"))) {
+	switch (req_selector(req)) {
+	case SEL_COMB: {
 		CONS* opnds = hd(tl(req));
 		CONS* env = tl(tl(req));
 
-		SEND(opnds, pr(cust, pr(ATOM("foldl"),
-			pr(a_inert, pr(MK_FUNC(pair_tail), pr(ATOM("eval"), env))))));
-	} else {
+		SEND(opnds, pr(cust, pr(SEL(FOLDL),
+			pr(a_inert, pr(MK_FUNC(pair_tail), pr(SEL(EVAL), env))))));
+		break;
+	}
+	default:
 		oper_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
 	}
 	DBUG_RETURN;
 }
@@ -1756,7 +2366,7 @@ BEH_DECL(define_match_beh)
 	ptree = hd(tl(state));
 	env = tl(tl(state));
 
-	SEND(ptree, pr(cust, pr(ATOM("match"), pr(value, env))));
+	SEND(ptree, pr(cust, pr(SEL(MATCH), pr(value, env))));
 	DBUG_RETURN;
 }
 /**
@@ -1792,7 +2402,7 @@ BEH_DECL(define_args_beh)
 	DBUG_PRINT("ptree", ("%s", cons_to_str(ptree)));
 	DBUG_PRINT("expr", ("%s", cons_to_str(expr)));
 	k_value = ACTOR(define_match_beh, pr(cust, pr(ptree, env)));
-	SEND(expr, pr(k_value, pr(ATOM("eval"), env)));
+	SEND(expr, pr(k_value, pr(SEL(EVAL), env)));
 	DBUG_RETURN;
 }
 
@@ -1822,7 +2432,7 @@ BEH_DECL(eval_args_beh)
 
 	DBUG_PRINT("expr", ("%s", cons_to_str(expr)));
 	DBUG_PRINT("env'", ("%s", cons_to_str(env_)));
-	SEND(expr, pr(cust, pr(ATOM("eval"), env_)));
+	SEND(expr, pr(cust, pr(SEL(EVAL), env_)));
 	DBUG_RETURN;
 }
 
@@ -1848,14 +2458,417 @@ BEH_DECL(eval_sequence_beh)
 	env = tl(tl(state));
 	ENSURE(WHAT == a_inert);
 
-	SEND(body, pr(cust, pr(ATOM("foldl"),
-		pr(a_inert, pr(MK_FUNC(pair_tail), pr(ATOM("eval"), env))))));
+	SEND(body, pr(cust, pr(SEL(FOLDL),
+		pr(a_inert, pr(MK_FUNC(pair_tail), pr(SEL(EVAL), env))))));
+	DBUG_RETURN;
+}
+/*
+ * Operative bodies are compiled, when their combiners are created, into
+ * a list of instructions.  Each instruction is (op . arg).  Instructions
+ * that branch name their target as a tail of the same list, so the code
+ * of a body is a small DAG that shares the code following a $if.
+ *
+ *	(PUSH . value)			push a self-evaluating value
+ *	(LOOKUP . name)			push the value bound to <name>
+ *	(DROP . _)				discard the top value (sequencing)
+ *	(COMB . (opnds . skip))	pop a combiner; an applicative pushes its
+ *							underlying combiner and continues with the
+ *							operand code, anything else gets (#comb, opnds)
+ *							and the result resumes at <skip>
+ *	(IF . (opnds . skip))	like COMB, but continues into the test only
+ *							when the combiner is the primitive $if
+ *	(CALL . opnds)			pop a combiner and send it (#comb, opnds)
+ *	(BRANCH . altn)			pop a Boolean, continue at <altn> if False
+ *	(APPLY . n)				pop <n> arguments and a combiner, apply it
+ *
+ * The compiler handles constants, symbol references, combinations and
+ * sequencing.  Every combiner is still found at run time, so operatives
+ * keep full fexpr semantics.  Operands are evaluated one after another,
+ * so a combination with more than one nested combination among its
+ * operands is left to CALL, which keeps their evaluation concurrent.
+ * A single code_beh activation runs the code until it must wait for
+ * another actor's answer.  Calls in tail position pass the original
+ * customer along, so tail recursion builds no chain of continuations.
+ */
+enum code_op {
+	OP_PUSH,
+	OP_LOOKUP,
+	OP_DROP,
+	OP_COMB,
+	OP_IF,
+	OP_CALL,
+	OP_BRANCH,
+	OP_APPLY
+};
+
+#define	CODE_OP(pc)		MK_INT(hd(hd(pc)))
+#define	CODE_ARG(pc)	tl(hd(pc))
+#define	CODE(op, arg, next)	pr(pr(NUMBER(op), (arg)), (next))
+
+/*
+ * The reader produces source trees of plain cells instead of actors.
+ * A pair is a cons, a symbol is its name atom, and every other leaf
+ * (including the () ending each list) is already its interned actor.
+ * The compiler accepts either form, so a top-level expression is run
+ * straight from its source tree.  Pair actors are only made when the
+ * tree is observed as an object: as the operands of an operative.
+ */
+#define	SRC_PAIRP(x)	(is_pr(x) || (actorp(x) && (_THIS(x) == pair_type)))
+#define	SRC_HD(x)		(is_pr(x) ? hd(x) : hd(_MINE(x)))
+#define	SRC_TL(x)		(is_pr(x) ? tl(x) : tl(_MINE(x)))
+
+static CONS*
+source_actor(CONS* tree)  /* OBJECT FOR A SOURCE TREE, MAKING PAIRS AS NEEDED */
+{
+	CONS* items = NIL;  /* list elements in reverse order */
+	CONS* x;
+
+	if (atomp(tree)) {
+		return get_symbol(tree);
+	}
+	for (x = tree; is_pr(x); x = tl(x)) {
+		items = pr(hd(x), items);
+	}
+	if (nilp(items)) {
+		return tree;  /* already an actor */
+	}
+	x = source_actor(x);
+	while (!nilp(items)) {
+		x = new_pair(source_actor(hd(items)), x);
+		items = tl(items);
+	}
+	return x;
+}
+
+static CONS*
+compile_expr(CONS* expr, CONS* next)  /* PREPEND CODE FOR expr TO next, OR NULL */
+{
+	CONS* opnds;
+	CONS* args;
+	CONS* code;
+	BEH beh;
+	int n;
+	int m;
+
+	if (atomp(expr)) {
+		return CODE(OP_LOOKUP, expr, next);  /* symbol in a source tree */
+	}
+	if (is_pr(expr)) {
+		beh = pair_type;  /* pair in a source tree */
+	} else if (actorp(expr)) {
+		beh = _THIS(expr);
+	} else {
+		return NULL;
+	}
+	if (beh == symbol_type) {
+		return CODE(OP_LOOKUP, _MINE(expr), next);
+	}
+	if ((beh == const_type) || (beh == bool_type) || (beh == unit_type)
+	|| (beh == null_type) || (beh == any_type)) {
+		return CODE(OP_PUSH, expr, next);
+	}
+	if (beh != pair_type) {
+		return NULL;
+	}
+	opnds = SRC_TL(expr);
+	args = NIL;  /* operands in reverse order */
+	m = 0;  /* number of nested combinations */
+	for (code = opnds; SRC_PAIRP(code); code = SRC_TL(code)) {
+		args = pr(SRC_HD(code), args);
+		if (SRC_PAIRP(hd(args))) {
+			++m;
+		}
+	}
+	if (!actorp(code) || (_THIS(code) != null_type)) {
+		return NULL;  /* improper operand list */
+	}
+	n = length(args);
+	code = SRC_HD(expr);
+	if ((n == 3)
+	&& ((code == ATOM("$if"))
+	|| (actorp(code) && (_THIS(code) == symbol_type) && (_MINE(code) == ATOM("$if"))))) {
+		CONS* altn = compile_expr(hd(args), next);
+		CONS* cnsq = compile_expr(hd(tl(args)), next);
+
+		if ((altn == NULL) || (cnsq == NULL)) {
+			return NULL;
+		}
+		code = compile_expr(hd(tl(tl(args))), CODE(OP_BRANCH, altn, cnsq));
+		if (code == NULL) {
+			return NULL;
+		}
+		code = CODE(OP_IF, pr(opnds, next), code);
+	} else if (m > 1) {
+		code = CODE(OP_CALL, opnds, next);
+	} else {
+		code = CODE(OP_APPLY, NUMBER(n), next);
+		while (!nilp(args)) {
+			code = compile_expr(hd(args), code);
+			if (code == NULL) {
+				return NULL;
+			}
+			args = tl(args);
+		}
+		code = CODE(OP_COMB, pr(opnds, next), code);
+	}
+	return compile_expr(SRC_HD(expr), code);
+}
+
+static CONS*
+compile_sequence(CONS* body)  /* CODE FOR A SEQUENCE OF EXPRESSIONS, OR NULL */
+{
+	CONS* exprs = NIL;  /* expressions in reverse order */
+	CONS* code;
+
+	for (code = body; actorp(code) && (_THIS(code) == pair_type); code = tl(_MINE(code))) {
+		exprs = pr(hd(_MINE(code)), exprs);
+	}
+	if (!actorp(code) || (_THIS(code) != null_type)) {
+		return NULL;
+	}
+	if (nilp(exprs)) {
+		return CODE(OP_PUSH, a_inert, NIL);
+	}
+	code = NIL;
+	while (!nilp(exprs)) {
+		code = compile_expr(hd(exprs), code);
+		if (code == NULL) {
+			return NULL;
+		}
+		exprs = tl(exprs);
+		if (!nilp(exprs)) {
+			code = CODE(OP_DROP, NIL, code);
+		}
+	}
+	return code;
+}
+
+/*
+ * Code is cached per body, so a $lambda or $vau evaluated again (to
+ * make a closure on each call, say) reuses the code compiled the first
+ * time.  Only immutable pairs are compiled, so the code never goes
+ * stale.  The cache holds weak references: an entry is dropped when
+ * either its body or its code is about to be collected.
+ */
+static HTAB* code_cache = NULL;  /* body->code, NIL if it can't be compiled */
+
+static BOOL
+code_cache_dead(HENTRY* e)  /* BODY OR CODE ABOUT TO BE COLLECTED */
+{
+	return ((gc_garbagep(e->key0) || gc_garbagep(e->value)) ? TRUE : FALSE);
+}
+
+static void
+code_sweep()  /* DROP CACHED CODE FOR COLLECTED BODIES */
+{
+	htab_prune_entries(code_cache, code_cache_dead);
+}
+
+static CONS*
+compile_body(CONS* body)  /* CACHED CODE FOR A SEQUENCE OF EXPRESSIONS, OR NULL */
+{
+	CONS* code;
+
+	if (code_cache == NULL) {
+		code_cache = new_htab(0);
+		gc_add_weak_hook(code_sweep);
+	}
+	code = htab_get(code_cache, body, NULL, NULL);
+	if (code == NULL) {
+		code = compile_sequence(body);
+		htab_put(code_cache, body, NULL, ((code != NULL) ? code : NIL));
+	} else if (nilp(code)) {
+		code = NULL;
+	} else {
+		(void)car(code);  /* an "aged" cell is live again */
+	}
+	return code;
+}
+
+static BOOL
+match_fast(CONS* ptree, CONS* value, CONS** map)  /* BIND SYNCHRONOUSLY, IF SIMPLE */
+{
+	BEH beh;
+
+	if (!actorp(ptree) || !actorp(value)) {
+		return FALSE;
+	}
+	beh = _THIS(ptree);
+	if (beh == symbol_type) {
+		*map = map_put(*map, _MINE(ptree), value);
+		return TRUE;
+	}
+	if (beh == any_type) {
+		return TRUE;
+	}
+	if (beh == null_type) {
+		return ((_THIS(value) == null_type) ? TRUE : FALSE);
+	}
+	if ((beh == pair_type) && (_THIS(value) == pair_type)) {
+		return ((match_fast(hd(_MINE(ptree)), hd(_MINE(value)), map)
+			&& match_fast(tl(_MINE(ptree)), tl(_MINE(value)), map)) ? TRUE : FALSE);
+	}
+	return FALSE;  /* let #match report the mismatch */
+}
+
+static BEH_DECL(code_beh);  /* forward */
+
+static CONS*
+code_cont(CONS* cust, CONS* env, CONS* pc, CONS* stack)  /* CUSTOMER FOR A CALL AT pc */
+{
+	if (nilp(pc) && nilp(stack)) {
+		return cust;  /* tail call */
+	}
+	return ACTOR(code_beh, pr(cust, pr(env, pr(pc, stack))));
+}
+
+static void
+code_run(CONS* cust, CONS* env, CONS* pc, CONS* stack)  /* RUN UNTIL DONE OR WAITING */
+{
+	CONS* arg;
+	CONS* comb;
+	CONS* value;
+	CONS* next;
+	int n;
+
+	while (!nilp(pc)) {
+		arg = CODE_ARG(pc);
+		switch (CODE_OP(pc)) {
+		case OP_PUSH:
+			stack = pr(arg, stack);
+			pc = tl(pc);
+			break;
+		case OP_LOOKUP:
+			pc = tl(pc);
+			if (_THIS(env) == env_type) {
+				value = env_lookup(env, arg, &next);
+				if (!nilp(value)) {
+					stack = pr(tl(value), stack);
+					break;
+				}
+			}
+			SEND(env, pr(code_cont(cust, env, pc, stack), pr(SEL(LOOKUP), arg)));
+			return;
+		case OP_DROP:
+			stack = tl(stack);
+			pc = tl(pc);
+			break;
+		case OP_COMB:
+		case OP_IF:
+			comb = hd(stack);
+			stack = tl(stack);
+			if ((CODE_OP(pc) == OP_COMB)
+			&& actorp(comb) && (_THIS(comb) == appl_type)) {
+				stack = pr(_MINE(comb), stack);
+				pc = tl(pc);
+				break;
+			}
+			if ((CODE_OP(pc) == OP_IF)
+			&& actorp(comb) && (_THIS(comb) == args_oper)
+			&& (_MINE(comb) == MK_FUNC(if_args_beh))) {
+				pc = tl(pc);
+				break;
+			}
+			pc = tl(arg);
+			SEND(comb, pr(code_cont(cust, env, pc, stack), pr(SEL(COMB), pr(source_actor(hd(arg)), env))));
+			return;
+		case OP_CALL:
+			comb = hd(stack);
+			stack = tl(stack);
+			pc = tl(pc);
+			SEND(comb, pr(code_cont(cust, env, pc, stack), pr(SEL(COMB), pr(source_actor(arg), env))));
+			return;
+		case OP_BRANCH:
+			value = hd(stack);
+			stack = tl(stack);
+			if (value == a_true) {
+				pc = tl(pc);
+			} else if (value == a_false) {
+				pc = arg;
+			} else {
+				THROW(pr(ATOM("Not-Understood"), pr(value, SEL(IF))));
+				return;
+			}
+			break;
+		case OP_APPLY:
+			pc = tl(pc);
+			value = NIL;
+			for (n = MK_INT(arg); n > 0; --n) {
+				value = pr(hd(stack), value);
+				stack = tl(stack);
+			}
+			comb = hd(stack);
+			stack = tl(stack);
+			arg = appl_fast_call(comb, value);
+			if (arg != NULL) {
+				stack = pr(arg, stack);
+				break;
+			}
+			if (_THIS(comb) == args_oper) {
+				SEND(ACTOR(MK_BEH(_MINE(comb)), pr(code_cont(cust, env, pc, stack), env)), value);
+			} else {
+				CONS* list = a_nil;
+
+				for (value = reverse(value); !nilp(value); value = tl(value)) {
+					list = new_pair(hd(value), list);
+				}
+				SEND(comb, pr(code_cont(cust, env, pc, stack), pr(SEL(COMB), pr(list, env))));
+			}
+			return;
+		default:
+			abort();  /* unknown instruction */
+		}
+	}
+	SEND(cust, hd(stack));
+}
+
+/**
+LET code_beh(cust, env, pc, stack) = \value.[
+	# continue running compiled code, with value pushed on stack
+]
+**/
+static
+BEH_DECL(code_beh)
+{
+	CONS* state = MINE;
+	CONS* cust;
+	CONS* env;
+	CONS* pc;
+	CONS* stack;
+
+	DBUG_ENTER("code_beh");
+	ENSURE(is_pr(state));
+	cust = hd(state);
+	ENSURE(actorp(cust));
+	ENSURE(is_pr(tl(state)) && is_pr(tl(tl(state))));
+	env = hd(tl(state));
+	pc = hd(tl(tl(state)));
+	stack = tl(tl(tl(state)));
+
+	code_run(cust, env, pc, pr(WHAT, stack));
 	DBUG_RETURN;
 }
+
+static void
+code_enter(CONS* cust, CONS* ptree, CONS* value, CONS* parent, CONS* code)  /* BIND, THEN RUN */
+{
+	CONS* map = NIL;
+	CONS* local;
+
+	if (match_fast(ptree, value, &map)) {
+		code_run(cust, ACTOR(env_type, pr(parent, map)), code, NIL);
+	} else {
+		local = ACTOR(env_type, pr(parent, NIL));
+		SEND(ptree, pr(
+			ACTOR(code_beh, pr(cust, pr(local, pr(CODE(OP_DROP, NIL, code), NIL)))),
+			pr(SEL(MATCH), pr(value, local))));
+	}
+}
+
 /**
-LET vau_type(ptree, body, s_env) = \(cust, req).[
+LET vau_type(ptree, body, s_env) = \(cust, req).[  # body may be compiled code
 	CASE req OF
-	(#comb, opnds, d_env) : [
+	(#comb, opnds, d_env) : [  # or code_enter(cust, ptree, formal, s_env, body)
 		CREATE local WITH Env(s_env)
 		CREATE formal WITH Pair(opnds, d_env)
 		SEND (k_eval, #match, formal, local) TO ptree
@@ -1894,26 +2907,34 @@ BEH_DECL(vau_type)
 	DBUG_PRINT("s_env", ("%s", cons_to_str(s_env)));
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req) && is_pr(tl(req))
-	&& (hd(req) == ATOM("comb"))) {
+	switch (req_selector(req)) {
+	case SEL_COMB: {
 		CONS* opnds = hd(tl(req));
 		CONS* d_env = tl(tl(req));
-		CONS* local = ACTOR(env_type, pr(s_env, NIL));
 		CONS* formal = ACTOR(pair_type, pr(opnds, d_env));
-		CONS* k_eval = ACTOR(eval_sequence_beh, pr(cust, pr(body, local)));
 
 		DBUG_PRINT("opnds", ("%s", cons_to_str(opnds)));
 		DBUG_PRINT("d_env", ("%s", cons_to_str(d_env)));
-		SEND(ptree, pr(k_eval, pr(ATOM("match"), pr(formal, local))));
-	} else {
+		if (actorp(body)) {
+			CONS* local = ACTOR(env_type, pr(s_env, NIL));
+			CONS* k_eval = ACTOR(eval_sequence_beh, pr(cust, pr(body, local)));
+
+			SEND(ptree, pr(k_eval, pr(SEL(MATCH), pr(formal, local))));
+		} else {
+			code_enter(cust, ptree, formal, s_env, body);  /* compiled body */
+		}
+		break;
+	}
+	default:
 		oper_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
 	}
 	DBUG_RETURN;
 }
 /**
 LET vau_evar_beh(cust, vars, env) = \(evar, body).[
 	CREATE actual WITH pair_type(vars, evar)
-	CREATE comb WITH vau_type(actual, body, env)
+	CREATE comb WITH vau_type(actual, compile_body(body) OR body, env)
 	SEND comb TO cust
 ]
 **/
@@ -1928,6 +2949,7 @@ BEH_DECL(vau_evar_beh)
 	CONS* evar;
 	CONS* body;
 	CONS* actual;
+	CONS* code;
 	CONS* comb;
 
 	DBUG_ENTER("vau_evar_beh");
@@ -1942,7 +2964,8 @@ BEH_DECL(vau_evar_beh)
 	body = tl(msg);
 
 	actual = ACTOR(pair_type, pr(vars, evar));
-	comb = ACTOR(vau_type, pr(actual, pr(body, env)));
+	code = compile_body(body);
+	comb = ACTOR(vau_type, pr(actual, pr(((code != NULL) ? code : body), env)));
 	SEND(cust, comb);
 	DBUG_RETURN;
 }
@@ -1971,7 +2994,7 @@ BEH_DECL(vau_vars_beh)
 	vars = hd(msg);
 	opnds = tl(msg);
 
-	SEND(opnds, pr(SELF, ATOM("as_pair")));
+	SEND(opnds, pr(SELF, SEL(AS_PAIR)));
 	BECOME(vau_evar_beh, pr(cust, pr(vars, env)));
 	DBUG_RETURN;
 }
@@ -2009,18 +3032,21 @@ BEH_DECL(vau_oper)
 
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req) && is_pr(tl(req))
-	&& (hd(req) == ATOM("comb"))) {
+	switch (req_selector(req)) {
+	case SEL_COMB: {
 		CONS* opnds = hd(tl(req));
 		CONS* env = tl(tl(req));
 		CONS* k_copy;
 		CONS* k_pair;
 
 		k_pair = ACTOR(vau_vars_beh, pr(cust, env));
-		k_copy = ACTOR(command_beh, pr(k_pair, ATOM("as_pair")));
-		SEND(opnds, pr(k_copy, ATOM("copy_immutable")));
-	} else {
+		k_copy = ACTOR(command_beh, pr(k_pair, SEL(AS_PAIR)));
+		SEND(opnds, pr(k_copy, SEL(COPY_IMMUTABLE)));
+		break;
+	}
+	default:
 		oper_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
 	}
 	DBUG_RETURN;
 }
@@ -2074,14 +3100,14 @@ BEH_DECL(unwrap_args_beh)
 	appl = hd(msg);
 	ENSURE(nilp(tl(msg)));
 
-	SEND(appl, pr(cust, ATOM("unwrap")));
+	SEND(appl, pr(cust, SEL(UNWRAP)));
 	DBUG_RETURN;
 }
 
 /**
-LET lambda_type(ptree, body, env) = \(cust, req).[
+LET lambda_type(ptree, body, env) = \(cust, req).[  # body may be compiled code
 	CASE req OF
-	(#comb, opnds, _) : [
+	(#comb, opnds, _) : [  # or code_enter(cust, ptree, opnds, env, body)
 		CREATE local WITH env_type(env)
 		SEND (k_eval, #match, opnds, local) TO ptree
 		CREATE k_eval WITH \$Inert.[  # eval_sequence_beh
@@ -2119,23 +3145,31 @@ BEH_DECL(lambda_type)
 	DBUG_PRINT("env", ("%s", cons_to_str(env)));
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req) && is_pr(tl(req))
-	&& (hd(req) == ATOM("comb"))) {
+	switch (req_selector(req)) {
+	case SEL_COMB: {
 		CONS* opnds = hd(tl(req));
 		/* CONS* env = tl(tl(req)); -- dynamic environment ignored */
-		CONS* local = ACTOR(env_type, pr(env, NIL));
-		CONS* k_eval = ACTOR(eval_sequence_beh, pr(cust, pr(body, local)));
 
 		DBUG_PRINT("opnds", ("%s", cons_to_str(opnds)));
-		SEND(ptree, pr(k_eval, pr(ATOM("match"), pr(opnds, local))));
-	} else {
+		if (actorp(body)) {
+			CONS* local = ACTOR(env_type, pr(env, NIL));
+			CONS* k_eval = ACTOR(eval_sequence_beh, pr(cust, pr(body, local)));
+
+			SEND(ptree, pr(k_eval, pr(SEL(MATCH), pr(opnds, local))));
+		} else {
+			code_enter(cust, ptree, opnds, env, body);  /* compiled body */
+		}
+		break;
+	}
+	default:
 		oper_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
 	}
 	DBUG_RETURN;
 }
 /**
 LET lambda_vars_beh(cust, env) = \(ptree, body).[
-	CREATE oper WITH lambda_type(ptree, body, env)
+	CREATE oper WITH lambda_type(ptree, compile_body(body) OR body, env)
 	SEND NEW appl_type(oper) TO cust
 ]
 **/
@@ -2148,6 +3182,7 @@ BEH_DECL(lambda_vars_beh)
 	CONS* msg = WHAT;
 	CONS* ptree;
 	CONS* body;
+	CONS* code;
 	CONS* oper;
 
 	DBUG_ENTER("lambda_vars_beh");
@@ -2159,7 +3194,8 @@ BEH_DECL(lambda_vars_beh)
 	ptree = hd(msg);
 	body = tl(msg);
 
-	oper = ACTOR(lambda_type, pr(ptree, pr(body, env)));
+	code = compile_body(body);
+	oper = ACTOR(lambda_type, pr(ptree, pr(((code != NULL) ? code : body), env)));
 	SEND(cust, ACTOR(appl_type, oper));
 	DBUG_RETURN;
 }
@@ -2193,18 +3229,92 @@ BEH_DECL(lambda_oper)
 
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req) && is_pr(tl(req))
-	&& (hd(req) == ATOM("comb"))) {
+	switch (req_selector(req)) {
+	case SEL_COMB: {
 		CONS* opnds = hd(tl(req));
 		CONS* env = tl(tl(req));
 		CONS* k_copy;
 		CONS* k_pair;
 
 		k_pair = ACTOR(lambda_vars_beh, pr(cust, env));
-		k_copy = ACTOR(command_beh, pr(k_pair, ATOM("as_pair")));
-		SEND(opnds, pr(k_copy, ATOM("copy_immutable")));
-	} else {
+		k_copy = ACTOR(command_beh, pr(k_pair, SEL(AS_PAIR)));
+		SEND(opnds, pr(k_copy, SEL(COPY_IMMUTABLE)));
+		break;
+	}
+	default:
+		oper_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
+	}
+	DBUG_RETURN;
+}
+
+/**
+LET let_oper(lambda) = \(cust, req).[
+	CASE req OF
+	(#comb, (bindings, body), env) : [
+		CREATE expr WITH Pair(Pair(lambda, Pair(map(car, bindings), body)),
+			map(cadr, bindings))
+		SEND (cust, #eval, env) TO expr
+	]
+	_ : oper_type(cust, req)
+	END
+]
+**/
+static
+BEH_DECL(let_oper)
+{
+	CONS* lambda = MINE;
+	CONS* msg = WHAT;
+	CONS* cust;
+	CONS* req;
+
+	DBUG_ENTER("let_oper");
+	ENSURE(actorp(lambda));
+	ENSURE(is_pr(msg));
+	cust = hd(msg);
+	ENSURE(actorp(cust));
+	req = tl(msg);
+
+	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
+	DBUG_PRINT("req", ("%s", cons_to_str(req)));
+	switch (req_selector(req)) {
+	case SEL_COMB: {
+		CONS* opnds = hd(tl(req));
+		CONS* env = tl(tl(req));
+		CONS* names = NIL;  /* in reverse order */
+		CONS* inits = NIL;  /* in reverse order */
+		CONS* formals = a_nil;
+		CONS* actuals = a_nil;
+		CONS* p;
+
+		if (!pair_valuep(opnds)) {
+			THROW(pr(ATOM("Not-Understood"), pr(SELF, req)));
+			break;
+		}
+		for (p = hd(_MINE(opnds)); pair_valuep(p); p = tl(_MINE(p))) {
+			CONS* binding = hd(_MINE(p));
+
+			if (!pair_valuep(binding) || !pair_valuep(tl(_MINE(binding)))) {
+				break;
+			}
+			names = pr(hd(_MINE(binding)), names);
+			inits = pr(cxr_path(NUMBER(5), binding), inits);  /* cadr */
+		}
+		if (!actorp(p) || (_THIS(p) != null_type)) {
+			THROW(pr(ATOM("Not-Understood"), pr(SELF, req)));
+			break;
+		}
+		for (; !nilp(names); names = tl(names), inits = tl(inits)) {
+			formals = new_pair(hd(names), formals);
+			actuals = new_pair(hd(inits), actuals);
+		}
+		p = new_pair(new_pair(lambda, new_pair(formals, tl(_MINE(opnds)))), actuals);
+		SEND(p, pr(cust, pr(SEL(EVAL), env)));
+		break;
+	}
+	default:
 		oper_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
 	}
 	DBUG_RETURN;
 }
@@ -2280,7 +3390,7 @@ BEH_DECL(if_test_beh)
 	ENSURE(actorp(cust));
 	ENSURE(actorp(bool));
 
-	SEND(bool, pr(cust, pr(ATOM("if"), tl(state))));
+	SEND(bool, pr(cust, pr(SEL(IF), tl(state))));
 	DBUG_RETURN;
 }
 /**
@@ -2322,7 +3432,7 @@ BEH_DECL(if_args_beh)
 	DBUG_PRINT("cnsq", ("%s", cons_to_str(cnsq)));
 	DBUG_PRINT("altn", ("%s", cons_to_str(altn)));
 	k_test = ACTOR(if_test_beh, pr(cust, pr(cnsq, pr(altn, env))));
-	SEND(test, pr(k_test, pr(ATOM("eval"), env)));
+	SEND(test, pr(k_test, pr(SEL(EVAL), env)));
 	DBUG_RETURN;
 }
 
@@ -2357,6 +3467,121 @@ BEH_DECL(cons_args_beh)
 	DBUG_RETURN;
 }
 
+/**
+LET list_star_args_beh(cust, env) = \(head, tail...).[
+	CASE tail OF
+	NIL : [ SEND head TO cust ]
+	_ : [ SEND cons_type(head, list*(tail...)) TO cust ]
+	END
+]
+**/
+static
+BEH_DECL(list_star_args_beh)
+{
+	CONS* state = MINE;
+	CONS* cust;
+	CONS* args = WHAT;
+	CONS* list;
+
+	DBUG_ENTER("list_star_args_beh");
+	ENSURE(is_pr(state));
+	cust = hd(state);
+	ENSURE(actorp(cust));
+	ENSURE(is_pr(args));
+
+	args = reverse(args);
+	list = hd(args);
+	for (args = tl(args); !nilp(args); args = tl(args)) {
+		list = ACTOR(cons_type, pr(hd(args), list));
+	}
+	SEND(cust, list);
+	DBUG_RETURN;
+}
+
+static BOOL
+equal_values(CONS* x, CONS* y)  /* SAME STRUCTURE OF PAIRS, WITH eq? LEAVES */
+{
+	while (x != y) {
+		if (!pair_valuep(x) || !pair_valuep(y)
+		|| !equal_values(hd(_MINE(x)), hd(_MINE(y)))) {
+			return FALSE;
+		}
+		x = tl(_MINE(x));
+		y = tl(_MINE(y));
+	}
+	return TRUE;
+}
+
+/**
+LET equal_args_beh(cust, env) = \(x, y, NIL).[
+	SEND equal_values(x, y) TO cust
+]
+**/
+static
+BEH_DECL(equal_args_beh)
+{
+	CONS* state = MINE;
+	CONS* cust;
+	CONS* msg = WHAT;
+	CONS* x;
+	CONS* y;
+
+	DBUG_ENTER("equal_args_beh");
+	ENSURE(is_pr(state));
+	cust = hd(state);
+	ENSURE(actorp(cust));
+	ENSURE(is_pr(msg));
+	x = hd(msg);
+	ENSURE(is_pr(tl(msg)));
+	y = hd(tl(msg));
+	ENSURE(nilp(tl(tl(msg))));
+
+	SEND(cust, (equal_values(x, y) ? a_true : a_false));
+	DBUG_RETURN;
+}
+
+/**
+LET apply_args_beh(cust, env) = \(appv, arg, opt...).[
+	LET env' = $opt(0) OR NEW env_type(NIL, NIL)
+	SEND (k_comb, #unwrap) TO appv
+	CREATE k_comb WITH command_beh(cust, #comb, arg, env')
+]
+**/
+static
+BEH_DECL(apply_args_beh)
+{
+	CONS* state = MINE;
+	CONS* cust;
+	CONS* msg = WHAT;
+	CONS* appv;
+	CONS* arg;
+	CONS* env;
+	CONS* req;
+
+	DBUG_ENTER("apply_args_beh");
+	ENSURE(is_pr(state));
+	cust = hd(state);
+	ENSURE(actorp(cust));
+	ENSURE(is_pr(msg));
+	appv = hd(msg);
+	ENSURE(actorp(appv));
+	ENSURE(is_pr(tl(msg)));
+	arg = hd(tl(msg));
+	if (is_pr(tl(tl(msg)))) {
+		env = hd(tl(tl(msg)));
+	} else {
+		env = ACTOR(env_type, pr(NIL, NIL));  /* (make-environment) */
+	}
+
+	req = pr(SEL(COMB), pr(arg, env));
+	if (_THIS(appv) == appl_type) {
+		SEND(_MINE(appv), pr(cust, req));
+	} else {
+		SEND(appv, pr(ACTOR(command_beh, pr(cust, req)), SEL(UNWRAP)));
+	}
+	DBUG_RETURN;
+}
+
 /**
 LET write_args_beh(cust, env) = \(sexpr, NIL).[
 	SEND (cust, #write) TO sexpr
@@ -2378,7 +3603,7 @@ BEH_DECL(write_args_beh)
 	sexpr = hd(msg);
 	ENSURE(nilp(tl(msg)));
 
-	SEND(sexpr, pr(cust, ATOM("write")));
+	SEND(sexpr, pr(cust, SEL(WRITE)));
 	DBUG_RETURN;
 }
 
@@ -2430,7 +3655,7 @@ BEH_DECL(set_car_args_beh)
 
 	DBUG_PRINT("p", ("%s", cons_to_str(p)));
 	DBUG_PRINT("a", ("%s", cons_to_str(a)));
-	SEND(p, pr(cust, pr(ATOM("set_car"), a)));
+	SEND(p, pr(cust, pr(SEL(SET_CAR), a)));
 	DBUG_RETURN;
 }
 
@@ -2460,7 +3685,7 @@ BEH_DECL(set_cdr_args_beh)
 
 	DBUG_PRINT("p", ("%s", cons_to_str(p)));
 	DBUG_PRINT("d", ("%s", cons_to_str(d)));
-	SEND(p, pr(cust, pr(ATOM("set_cdr"), d)));
+	SEND(p, pr(cust, pr(SEL(SET_CDR), d)));
 	DBUG_RETURN;
 }
 
@@ -2485,18 +3710,34 @@ BEH_DECL(copy_es_immutable_args_beh)
 	sexpr = hd(msg);
 	ENSURE(nilp(tl(msg)));
 
-	SEND(sexpr, pr(cust, ATOM("copy_immutable")));
+	SEND(sexpr, pr(cust, SEL(COPY_IMMUTABLE)));
 	DBUG_RETURN;
 }
 
+/*
+ * $concurrent sends every operand its #eval message from a single
+ * behavior invocation, so the dispatcher can interleave the evaluations
+ * freely instead of starting them one message at a time.
+ */
+static CONS*
+opnds_tuple(CONS* opnds)  /* OPERAND ACTORS OF A PROPER LIST, OR NULL */
+{
+	CONS* args = NIL;
+	CONS* p;
+
+	for (p = opnds; actorp(p) && (_THIS(p) == pair_type); p = tl(_MINE(p))) {
+		args = pr(hd(_MINE(p)), args);
+	}
+	if (!actorp(p) || (_THIS(p) != null_type)) {
+		return NULL;
+	}
+	return reverse(args);
+}
 /**
 LET concurrent_args_beh(env) = \args.[
-	CASE args OF
-	(first, rest) : [
+	FOR EACH first IN args : [
 		SEND (sink, #eval, env) TO first
-		SEND rest TO SELF
 	]
-	END
 ]
 **/
 static
@@ -2509,12 +3750,9 @@ BEH_DECL(concurrent_args_beh)
 
 	DBUG_PRINT("env", ("%s", cons_to_str(env)));
 	DBUG_PRINT("args", ("%s", cons_to_str(args)));
-	if (is_pr(args)) {
-		CONS* first = hd(args);
-		CONS* rest = tl(args);
-
-		SEND(first, pr(a_sink, pr(ATOM("eval"), env)));
-		SEND(SELF, rest);
+	while (is_pr(args)) {
+		SEND(hd(args), pr(a_sink, pr(SEL(EVAL), env)));
+		args = tl(args);
 	}
 	DBUG_RETURN;
 }
@@ -2523,7 +3761,7 @@ LET concurrent_oper = \(cust, req).[
 	CASE req OF
 	(#comb, opnds, env) : [
 		CREATE k_args WITH concurrent_args_beh(env)
-		SEND (k_args, #as_tuple) TO opnds
+		SEND (k_args, #as_tuple) TO opnds  # or directly, if a proper list
 		SEND Inert TO cust
 	]
 	_ : oper_type(cust, req)
@@ -2545,21 +3783,372 @@ BEH_DECL(concurrent_oper)
 
 	DBUG_PRINT("cust", ("%s", cons_to_str(cust)));
 	DBUG_PRINT("req", ("%s", cons_to_str(req)));
-	if (is_pr(req) && is_pr(tl(req))
-	&& (hd(req) == ATOM("comb"))) {
+	switch (req_selector(req)) {
+	case SEL_COMB: {
 		CONS* opnds = hd(tl(req));
 		CONS* env = tl(tl(req));
+		CONS* args = opnds_tuple(opnds);
 		CONS* k_args;
 
 		k_args = ACTOR(concurrent_args_beh, env);
-		SEND(opnds, pr(k_args, ATOM("as_tuple")));
+		if (args == NULL) {
+			SEND(opnds, pr(k_args, SEL(AS_TUPLE)));
+		} else {
+			SEND(k_args, args);
+		}
 		SEND(cust, a_inert);
-	} else {
+		break;
+	}
+	default:
 		oper_type(CFG);  /* DELEGATE BEHAVIOR */
+		break;
 	}
 	DBUG_RETURN;
 }
 
+/*
+ * Heap images capture the interned constants and symbols, the global
+ * actors and the ground environment (with everything defined in it),
+ * so a later run can start from a single mmap() and pack fix-up
+ * instead of re-building and re-evaluating the library.  Behaviors are
+ * stored as indexes into the table built by register_image_refs(),
+ * which only holds within one build, so each image starts with a
+ * header line naming the build that wrote it.
+ */
+#define	IMAGE_MAGIC	"KNLI"
+#define	IMAGE_HEADER	14	/* length of IMAGE_MAGIC " %08lx\n" */
+
+static ulint
+fnv_hash(ulint h, char* p, size_t n)  /* 32-BIT FNV-1a HASH, CONTINUING FROM h */
+{
+	while (n-- > 0) {
+		h ^= (unsigned char)*p++;
+		h = (h * 16777619UL) & 0xFFFFFFFFUL;
+	}
+	return h;
+}
+
+static ulint
+fnv_offset(ulint h, CONS* f)  /* FOLD THE OFFSET OF f FROM sink_beh INTO h */
+{
+	char buf[32];
+
+	sprintf(buf, "%lx", (ulint)(((WORD)f) - ((WORD)MK_FUNC(sink_beh))));
+	return fnv_hash(h, buf, strlen(buf));
+}
+
+static ulint
+build_identity()  /* HASH IDENTIFYING THIS BUILD OF THE PROGRAM */
+{
+	static char stamp[] = __DATE__ " " __TIME__;
+	ulint h = 2166136261UL;
+
+	h = fnv_hash(h, _Version, strlen(_Version));
+	h = fnv_hash(h, stamp, strlen(stamp));
+	h = fnv_offset(h, MK_FUNC(eval_args_beh));
+	h = fnv_offset(h, MK_FUNC(define_args_beh));
+	h = fnv_offset(h, MK_FUNC(apply_args_beh));
+	h = fnv_offset(h, MK_FUNC(boolean_and));
+	h = fnv_offset(h, MK_REF(env_type));
+	h = fnv_offset(h, MK_REF(appl_type));
+	h = fnv_offset(h, MK_REF(const_type));
+	return h;
+}
+
+static BEH_DECL(newline_beh);  /* forward */
+static BEH_DECL(report_beh);  /* forward */
+static BEH_DECL(assert_beh);  /* forward */
+
+static void
+register_image_refs()  /* BEHAVIORS AND FUNCTION REFERENCES THAT MAY BE PACKED */
+{
+	static BOOL registered = FALSE;
+
+	if (registered) {
+		return;
+	}
+	registered = TRUE;
+	pack_register_ref(MK_FUNC(make_env_args_beh));
+	pack_register_ref(MK_FUNC(eval_args_beh));
+	pack_register_ref(MK_FUNC(copy_es_immutable_args_beh));
+	pack_register_ref(MK_FUNC(set_car_args_beh));
+	pack_register_ref(MK_FUNC(set_cdr_args_beh));
+	pack_register_ref(MK_FUNC(newline_args_beh));
+	pack_register_ref(MK_FUNC(write_args_beh));
+	pack_register_ref(MK_FUNC(cons_args_beh));
+	pack_register_ref(MK_FUNC(if_args_beh));
+	pack_register_ref(MK_FUNC(eq_args_beh));
+	pack_register_ref(MK_FUNC(unwrap_args_beh));
+	pack_register_ref(MK_FUNC(wrap_args_beh));
+	pack_register_ref(MK_FUNC(define_args_beh));
+	pack_register_ref(MK_FUNC(list_star_args_beh));
+	pack_register_ref(MK_FUNC(equal_args_beh));
+	pack_register_ref(MK_FUNC(apply_args_beh));
+	pack_register_ref(MK_FUNC(boolean_and));
+	pack_register_ref(MK_FUNC(pair_tail));
+	pack_register_ref(MK_REF(env_type));
+	pack_register_ref(MK_REF(oper_type));
+	pack_register_ref(MK_REF(appl_type));
+	pack_register_ref(MK_REF(symbol_type));
+	pack_register_ref(MK_REF(any_type));
+	pack_register_ref(MK_REF(unit_type));
+	pack_register_ref(MK_REF(bool_type));
+	pack_register_ref(MK_REF(pair_type));
+	pack_register_ref(MK_REF(null_type));
+	pack_register_ref(MK_REF(const_type));
+	pack_register_ref(MK_FUNC(sink_beh));
+	pack_register_ref(MK_FUNC(throw_beh));
+	pack_register_ref(MK_FUNC(abort_beh));
+	pack_register_ref(MK_FUNC(command_beh));
+	pack_register_ref(MK_FUNC(join_rest_beh));
+	pack_register_ref(MK_FUNC(join_first_beh));
+	pack_register_ref(MK_FUNC(join_beh));
+	pack_register_ref(MK_FUNC(tag_beh));
+	pack_register_ref(MK_FUNC(fork_beh));
+	pack_register_ref(MK_FUNC(dotted_close_beh));
+	pack_register_ref(MK_FUNC(dotted_tail_beh));
+	pack_register_ref(MK_FUNC(object_type));
+	pack_register_ref(MK_FUNC(args_oper));
+	pack_register_ref(MK_FUNC(appl_args_beh));
+	pack_register_ref(MK_FUNC(type_pred_oper));
+	pack_register_ref(MK_FUNC(cxr_oper));
+	pack_register_ref(MK_FUNC(pair_comb_beh));
+	pack_register_ref(MK_FUNC(pair_tuple_beh));
+	pack_register_ref(MK_FUNC(pair_match_beh));
+	pack_register_ref(MK_FUNC(pair_copy_beh));
+	pack_register_ref(MK_FUNC(pair_map_beh));
+	pack_register_ref(MK_FUNC(pair_foldl_beh));
+	pack_register_ref(MK_FUNC(pair_write_tail_beh));
+	pack_register_ref(MK_FUNC(cons_type));
+	pack_register_ref(MK_FUNC(list_oper));
+	pack_register_ref(MK_FUNC(sequence_oper));
+	pack_register_ref(MK_FUNC(define_match_beh));
+	pack_register_ref(MK_FUNC(eval_sequence_beh));
+	pack_register_ref(MK_FUNC(code_beh));
+	pack_register_ref(MK_FUNC(vau_type));
+	pack_register_ref(MK_FUNC(vau_evar_beh));
+	pack_register_ref(MK_FUNC(vau_vars_beh));
+	pack_register_ref(MK_FUNC(vau_oper));
+	pack_register_ref(MK_FUNC(lambda_type));
+	pack_register_ref(MK_FUNC(lambda_vars_beh));
+	pack_register_ref(MK_FUNC(lambda_oper));
+	pack_register_ref(MK_FUNC(let_oper));
+	pack_register_ref(MK_FUNC(if_test_beh));
+	pack_register_ref(MK_FUNC(concurrent_args_beh));
+	pack_register_ref(MK_FUNC(concurrent_oper));
+	pack_register_ref(MK_FUNC(newline_beh));
+	pack_register_ref(MK_FUNC(report_beh));
+	pack_register_ref(MK_FUNC(assert_beh));
+}
+
+static CONS*
+image_roots()
+{
+	CONS* roots = NIL;
+
+	roots = pr(a_ground_env, roots);
+	roots = pr(a_kernel_env, roots);
+	roots = pr(a_ignore, roots);
+	roots = pr(a_nil, roots);
+	roots = pr(a_false, roots);
+	roots = pr(a_true, roots);
+	roots = pr(a_inert, roots);
+	roots = pr(a_sink, roots);
+	roots = pr(intern_map, roots);
+	return roots;
+}
+
+static CONS*
+next_image_root(CONS** roots)
+{
+	CONS* root = hd(*roots);
+
+	*roots = tl(*roots);
+	return root;
+}
+
+static BOOL
+set_image_roots(CONS* roots)  /* INSTALL ROOTS FROM image_roots() */
+{
+	static CONS* anchor = NULL;  /* protects the installed roots from gc */
+
+	if ((roots == NULL) || !consp(roots) || (length(roots) != 9)) {
+		return FALSE;
+	}
+	if (anchor == NULL) {
+		anchor = pr(NIL, NIL);
+		cfg_add_gc_root(CFG, anchor);
+	}
+	rplaca(anchor, roots);  /* release any previously installed image */
+	intern_map = next_image_root(&roots);
+	a_sink = next_image_root(&roots);
+	a_inert = next_image_root(&roots);
+	a_true = next_image_root(&roots);
+	a_false = next_image_root(&roots);
+	a_nil = next_image_root(&roots);
+	a_ignore = next_image_root(&roots);
+	a_kernel_env = next_image_root(&roots);
+	a_ground_env = next_image_root(&roots);
+	intern_reindex();
+	return TRUE;
+}
+
+static BOOL
+save_image(char* filename)
+{
+	FILE* f;
+
+	DBUG_ENTER("save_image");
+	register_image_refs();
+	if ((f = fopen(filename, "wb")) == NULL) {
+		perror(filename);
+		DBUG_RETURN FALSE;
+	}
+	fprintf(f, "%s %08lx\n", IMAGE_MAGIC, build_identity());
+	if (!pack_cons(image_roots(), pack_file_emit, f)) {
+		fprintf(stderr, "%s: heap holds an unregistered behavior\n", filename);
+		fclose(f);
+		remove(filename);
+		DBUG_RETURN FALSE;
+	}
+	if (fclose(f) != 0) {
+		perror(filename);
+		DBUG_RETURN FALSE;
+	}
+	DBUG_RETURN TRUE;
+}
+
+static BOOL
+load_image(char* filename)
+{
+	struct stat st;
+	char header[IMAGE_HEADER + 1];
+	char* base;
+	CONS* roots = NULL;
+	BOOL stale = FALSE;
+	int fd;
+
+	DBUG_ENTER("load_image");
+	register_image_refs();
+	if ((fd = open(filename, O_RDONLY)) < 0) {
+		perror(filename);
+		DBUG_RETURN FALSE;
+	}
+	if ((fstat(fd, &st) < 0)
+	|| ((base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)) {
+		perror(filename);
+		close(fd);
+		DBUG_RETURN FALSE;
+	}
+	sprintf(header, "%s %08lx\n", IMAGE_MAGIC, build_identity());
+	if ((st.st_size >= IMAGE_HEADER)
+	&& (memcmp(base, header, strlen(IMAGE_MAGIC)) == 0)) {
+		if (memcmp(base, header, IMAGE_HEADER) == 0) {
+			roots = unpack_mem(base + IMAGE_HEADER, st.st_size - IMAGE_HEADER);
+		} else {
+			stale = TRUE;
+		}
+	}
+	munmap(base, st.st_size);
+	close(fd);
+	if (stale) {
+		fprintf(stderr, "%s: image is from another build\n", filename);
+		DBUG_RETURN FALSE;
+	}
+	if (!set_image_roots(roots)) {
+		fprintf(stderr, "%s: not a kernel image\n", filename);
+		DBUG_RETURN FALSE;
+	}
+	DBUG_RETURN TRUE;
+}
+
+/*
+ * With -C, the state left by loading each file is cached beside it in
+ * <file>.cache, as a heap image keyed by a hash of the file's content
+ * chained with the key of the files loaded before it.  A later run that
+ * loads the same files in the same order restores that image instead of
+ * evaluating the source again.  The key starts from the build identity
+ * and the content of any heap image loaded at startup.  A file that
+ * writes any output or throws an exception is never cached, since
+ * restoring it would not repeat the output (or the failure).
+ */
+#define	CACHE_MAGIC	"KNLC"
+
+static ulint cache_key = 2166136261UL;  /* key for the files loaded so far */
+
+static void
+chain_cache_key(FILE* f)  /* FOLD THE CONTENT OF f INTO cache_key */
+{
+	char buf[SOURCE_BLOCK];
+	int fd = fileno(f);
+	ssize_t n;
+
+	while ((n = read(fd, buf, sizeof(buf))) > 0) {
+		cache_key = fnv_hash(cache_key, buf, (size_t)n);
+	}
+	lseek(fd, 0, SEEK_SET);
+}
+
+static void
+init_cache_key()  /* KEY FOR THE STATE BEFORE ANY FILE IS LOADED */
+{
+	char buf[16];
+	FILE* f;
+
+	sprintf(buf, "%08lx", build_identity());
+	cache_key = fnv_hash(cache_key, buf, strlen(buf));
+	cache_key = fnv_hash(cache_key, (hash_cons_pairs ? "H" : "-"), 1);
+	if ((image_in != NULL) && ((f = fopen(image_in, "rb")) != NULL)) {
+		chain_cache_key(f);
+		fclose(f);
+	}
+}
+
+static BOOL
+save_cache(char* filename)
+{
+	FILE* f;
+
+	DBUG_ENTER("save_cache");
+	register_image_refs();
+	if ((f = fopen(filename, "wb")) == NULL) {
+		perror(filename);
+		DBUG_RETURN FALSE;
+	}
+	fprintf(f, "%s %08lx\n", CACHE_MAGIC, cache_key);
+	if (!pack_cons(image_roots(), pack_file_emit, f)) {
+		fclose(f);
+		remove(filename);
+		DBUG_RETURN FALSE;
+	}
+	if (fclose(f) != 0) {
+		perror(filename);
+		DBUG_RETURN FALSE;
+	}
+	DBUG_RETURN TRUE;
+}
+
+static BOOL
+load_cache(char* filename)
+{
+	FILE* f;
+	ulint key;
+	CONS* roots = NULL;
+
+	DBUG_ENTER("load_cache");
+	register_image_refs();
+	if ((f = fopen(filename, "rb")) == NULL) {
+		DBUG_RETURN FALSE;  /* not cached yet */
+	}
+	if ((fscanf(f, CACHE_MAGIC " %lx", &key) == 1)
+	&& (key == cache_key) && (fgetc(f) == '\n')) {
+		roots = unpack_file(f);
+	}
+	fclose(f);
+	DBUG_PRINT("roots", ((roots == NULL) ? "stale" : "restored"));
+	DBUG_RETURN set_image_roots(roots);
+}
+
 /**
 CREATE sink WITH \_.[]
 
@@ -2587,6 +4176,11 @@ ground_env("$vau") = NEW vau_oper
 ground_env("$define!") = NEW args_oper(define_args_beh)
 ground_env("$sequence") = NEW sequence_oper
 ground_env("list") = NEW appl_type(NEW list_oper)
+ground_env("list*") = NEW appl_type(NEW args_oper(list_star_args_beh))
+ground_env("equal?") = NEW appl_type(NEW args_oper(equal_args_beh))
+ground_env("apply") = NEW appl_type(NEW args_oper(apply_args_beh))
+ground_env("$let") = NEW let_oper(ground_env("$lambda"))
+ground_env("c[ad]{1,4}r") = NEW appl_type(NEW cxr_oper(path))
 
 ground_env("environment?") = NEW appl_type(NEW type_pred_oper(env_type))
 ground_env("operative?") = NEW appl_type(NEW type_pred_oper(oper_type))
@@ -2602,19 +4196,26 @@ static void
 init_kernel()
 {
 	CONS* ground_map = NIL;
+	int path;
 
 	DBUG_ENTER("init_kernel");
+	input_file = stdin;
+	output_file = stdout;
+	current_sink = file_sink(output_file);
+
+	init_selectors();
+	init_env_index();
+	if ((image_in != NULL) && load_image(image_in)) {
+		DBUG_RETURN;  /* ground environment restored from image */
+	}
+
 	intern_map = pr(NIL, NIL);
 	cfg_add_gc_root(CFG, intern_map);	/* protect from gc */
+	intern_reindex();
 
 	a_sink = ACTOR(sink_beh, NIL);
 	cfg_add_gc_root(CFG, a_sink);		/* protect from gc */
 	
-	input_file = stdin;
-	output_file = stdout;
-	current_source = file_source(input_file);
-	current_sink = file_sink(output_file);
-
 	a_inert = ACTOR(unit_type, NIL);
 	cfg_add_gc_root(CFG, a_inert);		/* protect from gc */
 	a_true = ACTOR(bool_type, TRUE);
@@ -2631,7 +4232,7 @@ init_kernel()
 	ground_map = map_put(ground_map, ATOM("make-environment"),
 		ACTOR(appl_type,
 			ACTOR(args_oper, MK_FUNC(make_env_args_beh))));
-	ground_map = map_put(ground_map, ATOM("eval"),
+	ground_map = map_put(ground_map, SEL(EVAL),
 		ACTOR(appl_type,
 			ACTOR(args_oper, MK_FUNC(eval_args_beh))));
 	ground_map = map_put(ground_map, ATOM("copy-es-immutable"),
@@ -2646,7 +4247,7 @@ init_kernel()
 	ground_map = map_put(ground_map, ATOM("newline"),
 		ACTOR(appl_type,
 			ACTOR(args_oper, MK_FUNC(newline_args_beh))));
-	ground_map = map_put(ground_map, ATOM("write"),
+	ground_map = map_put(ground_map, SEL(WRITE),
 		ACTOR(appl_type,
 			ACTOR(args_oper, MK_FUNC(write_args_beh))));
 	ground_map = map_put(ground_map, ATOM("cons"),
@@ -2659,7 +4260,7 @@ init_kernel()
 			ACTOR(args_oper, MK_FUNC(eq_args_beh))));
 	ground_map = map_put(ground_map, ATOM("$lambda"),
 		ACTOR(lambda_oper, NIL));
-	ground_map = map_put(ground_map, ATOM("unwrap"),
+	ground_map = map_put(ground_map, SEL(UNWRAP),
 		ACTOR(appl_type,
 			ACTOR(args_oper, MK_FUNC(unwrap_args_beh))));
 	ground_map = map_put(ground_map, ATOM("wrap"),
@@ -2674,6 +4275,34 @@ init_kernel()
 	ground_map = map_put(ground_map, ATOM("list"),
 		ACTOR(appl_type,
 			ACTOR(list_oper, NIL)));
+	ground_map = map_put(ground_map, ATOM("list*"),
+		ACTOR(appl_type,
+			ACTOR(args_oper, MK_FUNC(list_star_args_beh))));
+	ground_map = map_put(ground_map, ATOM("equal?"),
+		ACTOR(appl_type,
+			ACTOR(args_oper, MK_FUNC(equal_args_beh))));
+	ground_map = map_put(ground_map, ATOM("apply"),
+		ACTOR(appl_type,
+			ACTOR(args_oper, MK_FUNC(apply_args_beh))));
+	ground_map = map_put(ground_map, ATOM("$let"),
+		ACTOR(let_oper, map_get_def(ground_map, ATOM("$lambda"), NIL)));
+	for (path = 2; path < 32; ++path) {  /* car, cdr, caar, ... cddddr */
+		char name[8];
+		char* s = name;
+		int n;
+
+		*s++ = 'c';
+		for (n = 1; (path >> n) > 1; ++n)
+			;
+		while (n-- > 0) {
+			*s++ = (((path >> n) & 1) ? 'd' : 'a');
+		}
+		*s++ = 'r';
+		*s = '\0';
+		ground_map = map_put(ground_map, ATOM(name),
+			ACTOR(appl_type,
+				ACTOR(cxr_oper, NUMBER(path))));
+	}
 
 	ground_map = map_put(ground_map, ATOM("environment?"),
 		ACTOR(appl_type,
@@ -2712,73 +4341,77 @@ init_kernel()
 
 #define	ONE_OF(c,s)	(((c) && strchr((s),(c))) ? TRUE : FALSE)
 
-CONS*
-read_sexpr(SOURCE* src)
+static CELL read_dot__cell;  /* marker returned for '.' inside a list */
+
+#define	READ_DOT	as_cons(&read_dot__cell)
+#define	READ_DATUM(x)	((!nilp(x) && !numberp(x) && ((x) != READ_DOT)) ? TRUE : FALSE)
+
+static CONS*
+read_item(SOURCE* src)  /* SOURCE TREE, NIL AT ')', READ_DOT, OR NUMBER ON ERROR */
 {
 	CONS* x;
 	int c;
 
-	DBUG_ENTER("read_sexpr");
+	DBUG_ENTER("read_item");
 	for (;;) {	/* skip whitespace */
-		c = MK_INT((src->get)(src));
+		c = SOURCE_PEEK(src);
 		if (c == ';') {
-			(src->next)(src);
+			SOURCE_SKIP(src);
 			for (;;) {  /* skip comment */
-				c = MK_INT((src->get)(src));
+				c = SOURCE_PEEK(src);
 				if ((c == '\n') || (c == '\r') || (c == EOF)) {
 					break;
 				}
-				(src->next)(src);
+				SOURCE_SKIP(src);
 			}
 		}
 		if (!isspace(c)) {
 			break;
 		}
-		(src->next)(src);
+		SOURCE_SKIP(src);
 	}
 	if (c == EOF) {
 		x = NUMBER(EOF);
 	} else if (c == '(') {
 		CONS* y = NIL;
 
-		(src->next)(src);
+		SOURCE_SKIP(src);
 		for (;;) {
-			x = read_sexpr(src);
-			if (actorp(x)) {
-				DBUG_PRINT("actor", ("x=%s", cons_to_str(x)));
+			x = read_item(src);
+			if (READ_DATUM(x)) {
 				y = pr(x, y);
-				DBUG_PRINT("actor", ("y=%s", cons_to_str(y)));
-			} else if (nilp(x) || is_pr(x)) {
-				x = (nilp(x) ? a_nil : hd(x));
-				DBUG_PRINT("close", ("x=%s", cons_to_str(x)));
-				DBUG_PRINT("close", ("y=%s", cons_to_str(y)));
-				while (is_pr(y)) {
-					x = ACTOR(pair_type, pr(hd(y), x));
-					y = tl(y);
+				continue;
+			}
+			if (x == READ_DOT) {
+				x = read_item(src);  /* explicit tail */
+				if (!READ_DATUM(x)) {
+					x = (numberp(x) ? x : NUMBER(')'));
+					DBUG_PRINT("error", ("x=%s", cons_to_str(x)));
+					break;
 				}
-				DBUG_PRINT("close", ("x=%s", cons_to_str(x)));
-				break;
+				if (!nilp(read_item(src))) {
+					x = NUMBER(')');  /* missing ')' */
+					break;
+				}
+			} else if (nilp(x)) {
+				x = a_nil;
 			} else {
 				DBUG_PRINT("error", ("x=%s", cons_to_str(x)));
 				break;
 			}
+			while (is_pr(y)) {
+				x = pr(hd(y), x);
+				y = tl(y);
+			}
+			DBUG_PRINT("close", ("x=%s", cons_to_str(x)));
+			break;
 		}
 	} else if (c == ')') {
-		(src->next)(src);
+		SOURCE_SKIP(src);
 		x = NIL;
 	} else if (c == '.') {
-		CONS* y;
-		
-		(src->next)(src);
-		x = read_sexpr(src);
-		DBUG_PRINT("dot", ("x=%s", cons_to_str(x)));
-		y = read_sexpr(src);
-		DBUG_PRINT("dot", ("y=%s", cons_to_str(y)));
-		if (nilp(y)) {
-			x = pr(x, y);
-		} else {
-			x = NUMBER(')');  /* missing ')' */
-		}
+		SOURCE_SKIP(src);
+		x = READ_DOT;
 	} else if (c == '"') {
 		x = NUMBER(c);  /* FIXME: implement string literals */
 	} else if (ispunct(c) && ONE_OF(c, "'`,[]{}|")) {
@@ -2787,8 +4420,8 @@ read_sexpr(SOURCE* src)
 		x = NUMBER(0);
 		do {
 			x = NUMBER((MK_INT(x) * 10) + (c - '0'));
-			(src->next)(src);
-			c = MK_INT((src->get)(src));
+			SOURCE_SKIP(src);
+			c = SOURCE_PEEK(src);
 		} while (isdigit(c));
 		if ((c == EOF) || isspace(c) || ONE_OF(c, "\"()")) {
 			x = get_const(x);
@@ -2801,8 +4434,8 @@ read_sexpr(SOURCE* src)
 		x = NIL;
 		do {
 			x = ATOM_X(x, tolower(c));  /* forced lowercase */
-			(src->next)(src);
-			c = MK_INT((src->get)(src));
+			SOURCE_SKIP(src);
+			c = SOURCE_PEEK(src);
 		} while (isgraph(c) && !ONE_OF(c, "\"()"));
 		if (sharp == TRUE) {
 			if (x == ATOM("#inert")) {
@@ -2813,17 +4446,29 @@ read_sexpr(SOURCE* src)
 				x = a_false;
 			} else if (x == ATOM("#ignore")) {
 				x = a_ignore;
-			} else {
-				x = get_symbol(x);
 			}
-		} else {
-			x = get_symbol(x);
 		}
 	}
 	DBUG_PRINT("x", ("%s", cons_to_str(x)));
 	DBUG_RETURN x;
 }
 
+static CONS*
+read_source(SOURCE* src)  /* SOURCE TREE, OR NIL/NUMBER ON ERROR/EOF */
+{
+	CONS* x = read_item(src);
+
+	return ((x == READ_DOT) ? NUMBER('.') : x);
+}
+
+CONS*
+read_sexpr(SOURCE* src)
+{
+	CONS* x = read_source(src);
+
+	return (READ_DATUM(x) ? source_actor(x) : x);
+}
+
 void
 run_repl(int batch)
 {
@@ -2841,6 +4486,7 @@ run_repl(int batch)
 			fprintf(stderr, "\nMessage limit of %d exceeded!\n", batch);
 			fprintf(stderr, "%d undelivered message(s)\n", cfg->q_count);
 		}
+		flush_output();  /* dispatch loop is idle */
 		if (cfg->t_count > 0) {
 			DBUG_PRINT("", ("waiting for timed event..."));
 			sleep(1);
@@ -2848,6 +4494,7 @@ run_repl(int batch)
 			return;		/* no more work to do! */
 		}
 	}
+	flush_output();
 	fprintf(stderr, "\nOutstanding messages exceeded limit of %d\n", cfg->q_limit);
 	abort();	/* abnormal termination */
 }
@@ -2869,6 +4516,7 @@ run_test(int limit)
 			DBUG_PRINT("", ("%d messages remain in queue.", cfg->q_count));
 			break;		/* excessive messaging */
 		}
+		flush_output();  /* dispatch loop is idle */
 		if (cfg->t_count > 0) {
 			DBUG_PRINT("", ("waiting for timed event..."));
 			sleep(1);
@@ -2900,6 +4548,7 @@ report_cons_stats()
 void
 prompt()
 {
+	flush_output();
 	fprintf(output_file, "\n> ");
 	fflush(output_file);
 }
@@ -2918,6 +4567,7 @@ BEH_DECL(newline_beh)
 	CONS* state = MINE;
 	
 	DBUG_ENTER("newline_beh");
+	flush_output();
 	fputc('\n', output_file);
 	fflush(output_file);
 	if (is_pr(state) && actorp(hd(state))) {
@@ -2941,7 +4591,7 @@ BEH_DECL(report_beh)
 	
 	DBUG_ENTER("report_beh");
 	cust = ACTOR(newline_beh, pr(cust, value));
-	SEND(value, pr(cust, ATOM("write")));
+	SEND(value, pr(cust, SEL(WRITE)));
 	BECOME(abort_beh, NIL);
 	DBUG_RETURN;
 }
@@ -2951,6 +4601,7 @@ read_eval_print_loop(FILE* f, BOOL interactive)
 {
 	CONS* cust;
 	CONS* expr;
+	CONS* code;
 	
 	DBUG_ENTER("read_eval_print_loop");
 	input_file = f;
@@ -2959,19 +4610,54 @@ read_eval_print_loop(FILE* f, BOOL interactive)
 		if (interactive) {
 			prompt();
 		}
-		expr = read_sexpr(current_source);
+		expr = read_source(current_source);
 		if (expr == NUMBER(EOF)) {
-			DBUG_RETURN a_inert;  /* end of input */
-		} else if (!actorp(expr)) {
-			DBUG_RETURN expr;  /* error */
+			expr = a_inert;  /* end of input */
+			break;
+		} else if (!READ_DATUM(expr)) {
+			break;  /* error */
 		}
 		cust = a_sink;
 		if (interactive) {
 			cust = ACTOR(report_beh, cust);
 		}
-		SEND(expr, pr(cust, pr(ATOM("eval"), a_ground_env)));  /* evaluate */
+		code = compile_expr(expr, NIL);
+		if (code != NULL) {
+			code_run(cust, a_ground_env, code, NIL);  /* evaluate */
+		} else {
+			SEND(source_actor(expr), pr(cust, pr(SEL(EVAL), a_ground_env)));
+		}
 		run_repl(M_limit);  /* actor dispatch loop */
-	}	
+	}
+	current_source = free_source(current_source);
+	DBUG_RETURN expr;
+}
+
+static void
+load_file(FILE* f, char* filename)  /* EVALUATE f, OR RESTORE ITS STATE FROM CACHE */
+{
+	char* cache;
+	size_t total;
+	long throws;
+
+	if (!use_cache) {
+		read_eval_print_loop(f, FALSE);
+		return;
+	}
+	chain_cache_key(f);
+	cache = NEWxN(char, strlen(filename) + sizeof(".cache"));
+	assert(cache != NULL);
+	sprintf(cache, "%s.cache", filename);
+	if (!load_cache(cache)) {
+		total = current_sink->total;
+		throws = throw_cnt;
+		if ((read_eval_print_loop(f, FALSE) == a_inert)
+		&& (current_sink->total == total)
+		&& (throw_cnt == throws)) {
+			save_cache(cache);
+		}
+	}
+	FREE(cache);
 }
 
 /**
@@ -3009,10 +4695,11 @@ assert_eval(CONS* expr, CONS* expect)
 
 	prompt();
 	cust = ACTOR(newline_beh, NIL);
-	SEND(expr, pr(cust, ATOM("write")));  /* echo expr to console */
+	SEND(expr, pr(cust, SEL(WRITE)));  /* echo expr to console */
+	run_test(M_limit);  /* finish echo before the result is reported */
 	cust = ACTOR(assert_beh, expect);
 	cust = ACTOR(report_beh, cust);
-	SEND(expr, pr(cust, pr(ATOM("eval"), a_ground_env)));
+	SEND(expr, pr(cust, pr(SEL(EVAL), a_ground_env)));
 	run_test(M_limit);
 	assert(_THIS(cust) == abort_beh);
 }
@@ -3021,12 +4708,28 @@ void
 test_kernel()
 {
 	SOURCE* src;
+	SBUF* sbuf;
+	SINK* sink;
+	FILE* f;
 	CONS* expr;
 	CONS* expect;
+	int i;
 
 	DBUG_ENTER("test_kernel");
 	TRACE(printf("--test_kernel--\n"));
 
+	/*
+	 * test message selectors
+	 */
+	assert(req_selector(SEL(WRITE)) == SEL_WRITE);
+	assert(req_selector(pr(SEL(WRITE), NIL)) == SEL_NONE);
+	assert(req_selector(pr(SEL(EVAL), NIL)) == SEL_EVAL);
+	assert(req_selector(SEL(EVAL)) == SEL_NONE);
+	assert(req_selector(pr(SEL(COMB), NIL)) == SEL_NONE);
+	assert(req_selector(pr(SEL(COMB), pr(NIL, NIL))) == SEL_COMB);
+	assert(req_selector(pr(ATOM("x"), NIL)) == SEL_NONE);
+	assert(req_selector(NUMBER(0)) == SEL_NONE);
+
 	/*
 	 * test character source
 	 */
@@ -3081,6 +4784,72 @@ test_kernel()
 	expect = NUMBER(EOF);
 	assert(equal(expect, expr));
 
+	/*
+	 * test source trees, and their pairs made on demand
+	 */
+	src = string_source("(x 1 . #t)");
+	expr = read_source(src);
+	assert(is_pr(expr) && (hd(expr) == ATOM("x")));
+	assert(tl(tl(expr)) == a_true);
+	expr = source_actor(expr);
+	assert(actorp(expr) && (_THIS(expr) == pair_type));
+	assert(hd(_MINE(expr)) == get_symbol(ATOM("x")));
+	assert(hd(_MINE(tl(_MINE(expr)))) == get_const(NUMBER(1)));
+	src = string_source("(x . 1 2)");
+	assert(read_source(src) == NUMBER(')'));
+
+	/*
+	 * test buffered file source across a block boundary
+	 */
+	f = tmpfile();
+	assert(f != NULL);
+	for (i = 0; i < SOURCE_BLOCK - 3; ++i) {
+		fputc(' ', f);
+	}
+	fputs("#inert 42", f);
+	rewind(f);
+	src = file_source(f);
+	assert(read_sexpr(src) == a_inert);
+	assert(read_sexpr(src) == get_const(NUMBER(42)));
+	assert(read_sexpr(src) == NUMBER(EOF));
+	assert((src->empty)(src) == a_true);
+	FREE(src->buf);
+	FREE(src);
+	fclose(f);
+
+	/*
+	 * test buffered file sink, including a write larger than a block
+	 */
+	f = tmpfile();
+	assert(f != NULL);
+	sink = file_sink(f);
+	assert((sink->put)(sink, NUMBER('(')) == a_true);
+	for (i = 0; i < SINK_BLOCK; ++i) {
+		assert((sink->put_cstr)(sink, "x ") == a_true);
+	}
+	sbuf = new_sbuf(SINK_BLOCK + 1);
+	for (i = 0; i <= SINK_BLOCK; ++i) {
+		sbuf_emit('y', sbuf);
+	}
+	assert((sink->put_bytes)(sink, sbuf->buf, sbuf->offset) == a_true);
+	sbuf = free_sbuf(sbuf);
+	assert((sink->put)(sink, NUMBER(')')) == a_true);
+	assert(ftell(f) < (3 * SINK_BLOCK + 3));  /* tail still buffered */
+	assert((sink->flush)(sink) == a_true);
+	assert(ftell(f) == (3 * SINK_BLOCK + 3));
+	FREE(sink->buf);
+	FREE(sink);
+	fclose(f);
+
+	hash_cons_pairs = TRUE;
+	src = string_source("((x y) (x y))");
+	expr = read_sexpr(src);
+	assert(actorp(expr));
+	src = string_source("((x y) (x y))");
+	expect = read_sexpr(src);
+	assert(expr == expect);  /* identical immutable trees share one actor */
+	hash_cons_pairs = FALSE;
+
 	/*
 	 * #inert
 	 * ==> #inert
@@ -3252,6 +5021,119 @@ test_kernel()
 	expect = get_const(NUMBER(1));
 	assert_eval(expr, expect);
 
+	/*
+	 * a new ground binding shadows a cached kernel binding
+	 * zz
+	 * ==> 1, then 2
+	 */
+	expr = get_symbol(ATOM("zz"));
+	SEND(a_kernel_env, pr(a_sink, pr(SEL(BIND), pr(ATOM("zz"), get_const(NUMBER(1))))));
+	run_test(M_limit);
+	assert_eval(expr, get_const(NUMBER(1)));
+	SEND(a_ground_env, pr(a_sink, pr(SEL(BIND), pr(ATOM("zz"), get_const(NUMBER(2))))));
+	run_test(M_limit);
+	assert_eval(expr, get_const(NUMBER(2)));
+
+	/*
+	 * primitives applied to constants and bound symbols
+	 * (eq? zz 2)
+	 * ==> #t
+	 * (null? () zz)
+	 * ==> #f
+	 */
+	expr = read_sexpr(string_source("(eq? zz 2)"));
+	assert_eval(expr, a_true);
+	expr = read_sexpr(string_source("(null? () zz)"));
+	assert_eval(expr, a_false);
+
+	/*
+	 * compiled operative bodies
+	 * (($lambda (x) ($define! y x) ($if (null? y) #f (eq? y 1))) 1)
+	 * ==> #t
+	 * (($vau (x) e (eval x e)) (null? ()))
+	 * ==> #t
+	 */
+	expr = read_sexpr(string_source(
+		"(($lambda (x) ($define! y x) ($if (null? y) #f (eq? y 1))) 1)"));
+	assert_eval(expr, a_true);
+	expr = read_sexpr(string_source(
+		"(($vau (x) e (eval x e)) (null? ()))"));
+	assert_eval(expr, a_true);
+
+	/*
+	 * a body is compiled only once
+	 */
+	expr = read_sexpr(string_source("(($if (null? x) 0 1) x)"));
+	expect = compile_body(expr);
+	assert(expect != NULL);
+	assert(compile_body(expr) == expect);
+
+	/*
+	 * save and restore a heap image
+	 * (($lambda (x) x) 42)
+	 * ==> 42
+	 */
+	register_image_refs();
+	sbuf = new_sbuf(1024);
+	assert(pack_cons(image_roots(), sbuf_emit, sbuf));
+	assert(set_image_roots(unpack_mem(sbuf->buf, sbuf->offset)));
+	sbuf = free_sbuf(sbuf);
+	expr = read_sexpr(string_source("(($lambda (x) x) 42)"));
+	expect = get_const(NUMBER(42));
+	assert_eval(expr, expect);
+
+	/*
+	 * (cadr (list* 1 (cons 2 3) (list 4)))
+	 * ==> (2 . 3)
+	 * (equal? (apply list* (list 1 2 (list 3))) (list 1 2 3))
+	 * ==> #t
+	 * ($let ((a 1) (b (cons 2 3))) (eq? (cdr b) 3))
+	 * ==> #t
+	 */
+	expr = read_sexpr(string_source("(cdadr (list* 1 (cons 2 3) (list 4)))"));
+	assert_eval(expr, get_const(NUMBER(3)));
+	expr = read_sexpr(string_source(
+		"(equal? (apply list* (list 1 2 (list 3))) (list 1 2 3))"));
+	assert_eval(expr, a_true);
+	expr = read_sexpr(string_source("(equal? (list 1 2) (list 1 3))"));
+	assert_eval(expr, a_false);
+	expr = read_sexpr(string_source("($let ((a 1) (b (cons 2 3))) (eq? (cdr b) 3))"));
+	assert_eval(expr, a_true);
+
+	/*
+	 * test library cache key hashing (FNV-1a test vectors)
+	 */
+	assert(fnv_hash(2166136261UL, "", 0) == 0x811c9dc5UL);
+	assert(fnv_hash(2166136261UL, "a", 1) == 0xe40c292cUL);
+	assert(fnv_hash(fnv_hash(2166136261UL, "foo", 2), "obar", 4) == 0xbf9cf968UL);
+
+	/*
+	 * a file that throws an exception is not cached
+	 * ($define! x 1) frob
+	 */
+	{
+		char name[64];
+		char cache[64 + sizeof(".cache")];
+		struct stat st;
+		ulint key = cache_key;
+		FILE* f;
+
+		sprintf(name, "/tmp/kernel%ld.knl", (long)getpid());
+		f = fopen(name, "w+");
+		assert(f != NULL);
+		fputs("($define! x 1)\nfrob\n", f);
+		fflush(f);
+		rewind(f);
+		sprintf(cache, "%s.cache", name);
+		use_cache = TRUE;
+		load_file(f, name);
+		use_cache = FALSE;
+		fclose(f);
+		assert(stat(cache, &st) < 0);
+		unlink(name);
+		cache_key = key;
+	}
+
 /* ...ADD TESTS HERE... */
 
 #if 1
@@ -3261,11 +5143,107 @@ test_kernel()
 	DBUG_RETURN;
 }
 
+/*
+ * The benchmark (-b) compares the primitive accessors and combiners with
+ * the Kernel definitions they replaced in library.knl.  Each expression
+ * is evaluated repeatedly in an environment holding the Kernel versions,
+ * and again in one that sees the primitives, counting messages and time.
+ * The library $let depended on an undefined map, so it is compared with
+ * the equivalent $lambda combination instead.
+ */
+#define	BENCH_REPEAT	1000
+#define	BENCH_LIMIT		(1000 * 1000)	/* messages per evaluation */
+
+static char* bench_library[] = {
+	"($define! car ($lambda ((x . #ignore)) x))",
+	"($define! cdr ($lambda ((#ignore . x)) x))",
+	"($define! cadr ($lambda ((#ignore x . #ignore)) x))",
+	"($define! caddr ($lambda ((#ignore . (#ignore . (x . #ignore)))) x))",
+	"($define! equal? ($lambda (x y) ($if (pair? x) \
+	($if (equal? (car x) (car y)) (equal? (cdr x) (cdr y)) #f) \
+	(eq? x y))))",
+	"($define! apply ($lambda (appv arg . opt) \
+	(eval (cons (unwrap appv) arg) \
+	($if (null? opt) (make-environment) (car opt)))))",
+	"($define! list* ($lambda (head . tail) \
+	($if (null? tail) head (cons head (apply list* tail)))))",
+	NULL
+};
+
+static struct {
+	char*		name;
+	char*		expr;		/* expression using the primitives */
+	char*		lib_expr;	/* expression using the library, if different */
+} bench_case[] = {
+	{ "car",	"(car (list 1 2 3))",		NULL },
+	{ "cadr",	"(cadr (list 1 2 3))",		NULL },
+	{ "caddr",	"(caddr (list 1 2 3))",		NULL },
+	{ "equal?",	"(equal? (list 1 (list 2 3) 4) (list 1 (list 2 3) 4))",	NULL },
+	{ "list*",	"(list* 1 2 (list 3 4))",	NULL },
+	{ "apply",	"(apply list (list 1 2 3))",	NULL },
+	{ "$let",	"($let ((a 1) (b 2)) (cons a b))",	"(($lambda (a b) (cons a b)) 1 2)" },
+	{ NULL,		NULL,						NULL }
+};
+
+static double
+bench_msg_count()
+{
+	return (((double)CFG->msg_cnt_hi * 2147483648.0) + CFG->msg_cnt_lo);
+}
+
+static void
+bench_eval(char* source, CONS* env, double* msgs, double* usecs)
+{
+	CONS* expr = read_sexpr(string_source(source));
+	double count = bench_msg_count();
+	clock_t start = clock();
+	int i;
+
+	for (i = 0; i < BENCH_REPEAT; ++i) {
+		SEND(expr, pr(a_sink, pr(SEL(EVAL), env)));
+		run_repl(BENCH_LIMIT);
+	}
+	*usecs = (((double)(clock() - start) * 1000000.0) / CLOCKS_PER_SEC) / BENCH_REPEAT;
+	*msgs = (bench_msg_count() - count) / BENCH_REPEAT;
+}
+
+void
+run_benchmark()
+{
+	CONS* lib_env = ACTOR(env_type, pr(a_ground_env, NIL));
+	CONS* prim_env = ACTOR(env_type, pr(a_ground_env, NIL));
+	SOURCE* src;
+	CONS* expr;
+	double lib_msgs, prim_msgs;
+	double lib_usecs, prim_usecs;
+	int i;
+
+	DBUG_ENTER("run_benchmark");
+	cfg_add_gc_root(CFG, pr(lib_env, prim_env));	/* protect from gc */
+	for (i = 0; bench_library[i] != NULL; ++i) {
+		src = string_source(bench_library[i]);
+		expr = read_sexpr(src);
+		src = free_source(src);
+		SEND(expr, pr(a_sink, pr(SEL(EVAL), lib_env)));
+		run_repl(M_limit);
+	}
+	fprintf(output_file, "%-8s %10s %10s %10s %10s\n",
+		"", "lib msgs", "prim msgs", "lib usec", "prim usec");
+	for (i = 0; bench_case[i].name != NULL; ++i) {
+		bench_eval((bench_case[i].lib_expr ? bench_case[i].lib_expr : bench_case[i].expr),
+			lib_env, &lib_msgs, &lib_usecs);
+		bench_eval(bench_case[i].expr, prim_env, &prim_msgs, &prim_usecs);
+		fprintf(output_file, "%-8s %10.1f %10.1f %10.2f %10.2f\n",
+			bench_case[i].name, lib_msgs, prim_msgs, lib_usecs, prim_usecs);
+	}
+	DBUG_RETURN;
+}
+
 void
 usage(void)
 {
 	fprintf(stderr, "\
-usage: %s [-ti]  [-M message limit] [-# dbug] file...\n",
+usage: %s [-tiHCb]  [-M message limit] [-I image] [-S image] [-# dbug] file...\n",
 		_Program);
 	exit(EXIT_FAILURE);
 }
@@ -3282,14 +5260,20 @@ main(int argc, char** argv)
 	int c;
 	BOOL test_mode = FALSE;			/* flag to run unit tests */
 	BOOL interactive = FALSE;		/* flag to run unit tests */
+	BOOL benchmark = FALSE;			/* flag to run the benchmark */
 
 	DBUG_ENTER("main");
 	DBUG_PROCESS(argv[0]);
-	while ((c = getopt(argc, argv, "tiM:#:V")) != EOF) {
+	while ((c = getopt(argc, argv, "tiHCbM:I:S:#:V")) != EOF) {
 		switch(c) {
 		case 't':	test_mode = TRUE;		break;
 		case 'i':	interactive = TRUE;		break;
+		case 'H':	hash_cons_pairs = TRUE;	break;
+		case 'C':	use_cache = TRUE;		break;
+		case 'b':	benchmark = TRUE;		break;
 		case 'M':	M_limit = atoi(optarg);	break;
+		case 'I':	image_in = optarg;		break;
+		case 'S':	image_out = optarg;		break;
 		case '#':	DBUG_PUSH(optarg);		break;
 		case 'V':	banner();				exit(EXIT_SUCCESS);
 		case '?':							usage();
@@ -3299,6 +5283,7 @@ main(int argc, char** argv)
 	banner();
 	CFG = new_configuration(1000);
 	init_kernel();  /* ==== INITIALIZE GLOBAL CONFIGURATION ==== */
+	init_cache_key();
 	if (test_mode) {
 		test_kernel();	/* this test involves running the dispatch loop */
 		fputc('\n', output_file);
@@ -3313,9 +5298,15 @@ main(int argc, char** argv)
 			exit(EXIT_FAILURE);
 		}
 		fprintf(output_file, "Loading %s\n", filename);
-		read_eval_print_loop(f, FALSE);
+		load_file(f, filename);
 		fclose(f);
 	}
+	if ((image_out != NULL) && !save_image(image_out)) {
+		exit(EXIT_FAILURE);
+	}
+	if (benchmark) {
+		run_benchmark();
+	}
 	if (interactive) {
 		fprintf(output_file, "Entering INTERACTIVE mode.\n");
 		read_eval_print_loop(stdin, TRUE);
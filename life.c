@@ -8,6 +8,7 @@ static char	_Version[] = "2008-05-12";
 static char	_Copyright[] = "Copyright 2008 Dale Schumacher";
 
 #include <getopt.h>
+#include <limits.h>
 #include "abe.h"
 
 #include "dbug.h"
@@ -113,6 +114,241 @@ print_grid()
 	}
 }
 
+/*
+ * Patterns.  Without a pattern file, the compiled-in grid is used.
+ */
+static char* pattern = NULL;	/* <pattern_h> rows of <pattern_w> FULL/EMPTY */
+static int pattern_w = X_MAX;
+static int pattern_h = Y_MAX;
+static int grid_w = X_MAX;
+static int grid_h = Y_MAX;
+
+int
+get_pattern_value(int x, int y)
+{
+	if (pattern == NULL) {
+		return get_grid_value(x, y);
+	}
+	return pattern[y * pattern_w + x];
+}
+
+char*
+read_text(FILE* f)
+/* read all of <f> into a NUL-terminated buffer */
+{
+	char* buf;
+	char* p;
+	size_t size = 4096;
+	size_t len = 0;
+	size_t n;
+
+	buf = NEWxN(char, size);
+	while (buf != NULL) {
+		n = fread(buf + len, 1, size - len - 1, f);
+		len += n;
+		if (len + 1 < size) {
+			buf[len] = '\0';
+			break;
+		}
+		size *= 2;
+		p = realloc(buf, size);
+		if (p == NULL) {
+			FREE(buf);
+		}
+		buf = p;
+	}
+	return buf;
+}
+
+char*
+next_line(char* s)
+{
+	while ((*s != '\0') && (*s != '\n')) {
+		++s;
+	}
+	return ((*s == '\n') ? (s + 1) : s);
+}
+
+char*
+parse_rle(char* s)
+/*
+ * Decode a run-length encoded pattern, with <s> at the header line
+ * ("x = <w>, y = <h>[, rule = B3/S23]"), returning an error message or NULL.
+ */
+{
+	char rule[64];
+	int x, y, n;
+
+	rule[0] = '\0';
+	if (sscanf(s, " x = %d , y = %d , rule = %63s", &pattern_w, &pattern_h, rule) < 2) {
+		return "bad RLE header";
+	}
+	if ((rule[0] != '\0') && (strcmp(rule, "B3/S23") != 0) && (strcmp(rule, "b3/s23") != 0)
+	&& (strcmp(rule, "23/3") != 0)) {
+		return "unsupported rule";
+	}
+	if ((pattern_w < 1) || (pattern_h < 1) || (pattern_h > INT_MAX / pattern_w)) {
+		return "bad RLE size";
+	}
+	if ((pattern = NEWxN(char, pattern_w * pattern_h)) == NULL) {
+		return "RLE pattern too large";
+	}
+	memset(pattern, EMPTY, pattern_w * pattern_h);
+	x = y = n = 0;
+	for (s = next_line(s); (*s != '\0') && (*s != '!'); ++s) {
+		if (isdigit(*s)) {
+			if (n > (INT_MAX - 9) / 10) {
+				return "bad RLE run count";
+			}
+			n = n * 10 + (*s - '0');
+			continue;
+		}
+		if (isspace(*s)) {
+			continue;
+		}
+		if (n == 0) {
+			n = 1;
+		}
+		if (*s == '$') {
+			y = ((n > pattern_h - y) ? pattern_h : (y + n));	/* y <= pattern_h */
+			x = 0;
+		} else if ((*s == 'b') || (*s == '.')) {
+			x = ((n > pattern_w - x) ? pattern_w : (x + n));	/* x <= pattern_w */
+		} else if (isalpha(*s)) {
+			if ((y >= pattern_h) || (n > pattern_w - x)) {
+				return "cells outside RLE size";
+			}
+			memset(pattern + y * pattern_w + x, FULL, n);
+			x += n;
+		} else {
+			return "bad RLE character";
+		}
+		n = 0;
+	}
+	return NULL;
+}
+
+char*
+parse_plaintext(char* s)
+/* decode a plaintext pattern ('.' dead, 'O' live), returning an error message or NULL */
+{
+	char* p;
+	int x, y;
+
+	pattern_w = pattern_h = 0;
+	for (p = s; *p != '\0'; p = next_line(p)) {
+		if (*p == '!') {
+			continue;
+		}
+		for (x = 0; (p[x] != '\0') && (p[x] != '\n') && (p[x] != '\r'); ++x)
+			;
+		if (x > pattern_w) {
+			pattern_w = x;
+		}
+		++pattern_h;
+	}
+	if ((pattern_w < 1) || (pattern_h < 1)) {
+		return "empty pattern";
+	}
+	if ((pattern_h > INT_MAX / pattern_w)
+	|| ((pattern = NEWxN(char, pattern_w * pattern_h)) == NULL)) {
+		return "plaintext pattern too large";
+	}
+	memset(pattern, EMPTY, pattern_w * pattern_h);
+	for (y = 0, p = s; *p != '\0'; p = next_line(p)) {
+		if (*p == '!') {
+			continue;
+		}
+		for (x = 0; (p[x] != '\0') && (p[x] != '\n') && (p[x] != '\r'); ++x) {
+			if ((p[x] == 'O') || (p[x] == 'o') || (p[x] == '*')) {
+				pattern[y * pattern_w + x] = FULL;
+			} else if ((p[x] != '.') && !isspace(p[x])) {
+				return "bad plaintext character";
+			}
+		}
+		++y;
+	}
+	return NULL;
+}
+
+BOOL
+load_pattern(char* filename)
+/* read an RLE or plaintext pattern file */
+{
+	FILE* f;
+	char* text;
+	char* s;
+	char* err;
+
+	DBUG_ENTER("load_pattern");
+	if ((f = fopen(filename, "r")) == NULL) {
+		perror(filename);
+		DBUG_RETURN FALSE;
+	}
+	text = read_text(f);
+	fclose(f);
+	if (text == NULL) {
+		fprintf(stderr, "%s: out of memory\n", filename);
+		DBUG_RETURN FALSE;
+	}
+	for (s = text; *s == '#'; s = next_line(s))	/* RLE comments */
+		;
+	while (isspace(*s)) {
+		++s;
+	}
+	if (*s == 'x') {
+		err = parse_rle(s);
+	} else {
+		err = parse_plaintext(text);
+	}
+	FREE(text);
+	if (err != NULL) {
+		fprintf(stderr, "%s: %s\n", filename, err);
+		if (pattern != NULL) {
+			FREE(pattern);
+		}
+		DBUG_RETURN FALSE;
+	}
+	DBUG_PRINT("", ("pattern %dx%d", pattern_w, pattern_h));
+	DBUG_RETURN TRUE;
+}
+
+/*
+ * Benchmark statistics, for headless runs.
+ */
+static BOOL headless = FALSE;
+static long peak_cells = 0;
+
+void
+note_cell_usage()
+/* track the peak number of cells allocated */
+{
+	long n;
+
+	n = (long)(GC_SIZE(GC_FRESH_LIST) + GC_SIZE(GC_AGED_LIST) + GC_SIZE(GC_SCAN_LIST));
+	if (n > peak_cells) {
+		peak_cells = n;
+	}
+}
+
+void
+report_benchmark(CONFIG* cfg, int gens, clock_t start)
+{
+	double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+	double msgs;
+
+	printf("%d generations of %dx%d in %.3f seconds", gens, grid_w, grid_h, secs);
+	if (secs > 0.0) {
+		printf(", %.1f generations/second, %.0f cells/second",
+			gens / secs, (double)grid_w * grid_h * gens / secs);
+	}
+	printf("\n");
+	if ((cfg != NULL) && (gens > 0)) {
+		msgs = (double)cfg->msg_cnt_hi * 2147483648.0 + cfg->msg_cnt_lo;
+		printf("%.1f messages/generation, %ld peak cells\n", msgs / gens, peak_cells);
+	}
+}
+
 /**
 int_generator(next:<next>){step:<step>, limit:<limit>, label:<label>, ctx:<ctx>, send-to:<send-to>} =
 	IF preceeds?(0, <step>)
@@ -396,23 +632,500 @@ life_tick(CONFIG* cfg)
 	DBUG_RETURN;
 }
 
+/*
+ * Tiled Life, for large grids.
+ *
+ * The grid is split into rectangular tiles, each owned by one actor.
+ * A tile keeps its cells packed one bit per cell in a board padded by
+ * a one-cell halo, which holds copies of the neighboring tiles' edge
+ * cells.  There are two boards, indexed by generation parity.  After
+ * reaching generation <g>, a tile sends its edges for <g> to its eight
+ * neighbors, which store them in the halo of their own board for <g>.
+ * Once all eight pieces of its halo for <g> have arrived, a tile steps
+ * to <g>+1, so no tile can get more than one generation ahead of its
+ * neighbors and no global barrier is needed.
+ */
+typedef unsigned long	LIFE_WORD;
+
+#define	LIFE_BITS	((int)(CHAR_BIT * sizeof(LIFE_WORD)))
+#define	EDGE_BITS	16		/* edge bits carried by each NUMBER in a message */
+#define	LIFE_BATCH	100000	/* messages dispatched between collections */
+
+typedef struct life_tile TILE;
+struct life_tile {
+	int			x0, y0;		/* grid position of upper-left cell */
+	int			w, h;		/* size in cells */
+	int			span;		/* words per padded row */
+	int			gen;		/* current generation */
+	int			need[2];	/* halo pieces missing, by generation parity */
+	LIFE_WORD*	board[2];	/* padded boards, by generation parity */
+	CONS*		actor;
+};
+
+static int tile_size = 64;
+static int tiles_x;
+static int tiles_y;
+static TILE* tiles;
+static int gen_limit;
+
+static CONS* gen_symbol = NIL;
+static CONS* side_symbol = NIL;
+static CONS* edge_symbol = NIL;
+static CONS* tile_symbol = NIL;
+static CONS* north_symbol = NIL;
+static CONS* south_symbol = NIL;
+static CONS* east_symbol = NIL;
+static CONS* west_symbol = NIL;
+static CONS* north_east_symbol = NIL;
+static CONS* north_west_symbol = NIL;
+static CONS* south_east_symbol = NIL;
+static CONS* south_west_symbol = NIL;
+
+#define	TILE_AT(i,j)	(&tiles[clamp_tile_y(j) * tiles_x + clamp_tile_x(i)])
+#define	BOARD_BIT(t,b,x,y) \
+	(((b)[(y) * (t)->span + (x) / LIFE_BITS] >> ((x) % LIFE_BITS)) & 1)
+
+int
+clamp_tile_x(int i)
+{
+	return ((i + tiles_x) % tiles_x);
+}
+
+int
+clamp_tile_y(int j)
+{
+	return ((j + tiles_y) % tiles_y);
+}
+
+void
+set_board_bit(TILE* t, LIFE_WORD* b, int x, int y, int value)
+{
+	LIFE_WORD* p = &b[y * t->span + x / LIFE_BITS];
+	LIFE_WORD m = ((LIFE_WORD)1) << (x % LIFE_BITS);
+
+	if (value) {
+		*p |= m;
+	} else {
+		*p &= ~m;
+	}
+}
+
+int
+get_tile_value(int x, int y)
+/* read a cell of the tiled grid, by grid position */
+{
+	TILE* t;
+
+	x = (x + grid_w) % grid_w;
+	y = (y + grid_h) % grid_h;
+	t = TILE_AT(x / tile_size, y / tile_size);
+	return (BOARD_BIT(t, t->board[t->gen & 1], x - t->x0 + 1, y - t->y0 + 1)
+		? FULL : EMPTY);
+}
+
+/*
+ * Neighbors of the cells in word <k> of a packed row, lined up with them.
+ */
+#define	WEST_OF(r,k)	(((r)[k] << 1) | (((k) > 0) ? ((r)[(k) - 1] >> (LIFE_BITS - 1)) : 0))
+#define	EAST_OF(r,k,n)	(((r)[k] >> 1) | (((k) + 1 < (n)) ? ((r)[(k) + 1] << (LIFE_BITS - 1)) : 0))
+
+LIFE_WORD
+inside_mask(int k, int w)
+/* bits of word <k> in a padded row that hold cells 1..<w> */
+{
+	LIFE_WORD m = ~((LIFE_WORD)0);
+	int lo = k * LIFE_BITS;
+
+	if (lo == 0) {
+		m &= ~((LIFE_WORD)1);			/* west halo */
+	}
+	if (w + 1 - lo < LIFE_BITS) {
+		m &= ((LIFE_WORD)1 << (w + 1 - lo)) - 1;	/* east halo and beyond */
+	}
+	return m;
+}
+
+void
+tile_step(TILE* t, LIFE_WORD* src, LIFE_WORD* dst)
+/*
+ * Compute the inside of <dst> from <src>, leaving the halo of <dst>
+ * alone.  Neighbor counts are kept bit-sliced, one bit-plane per word,
+ * so a whole word of cells is counted with a few full adders.
+ */
+{
+	int y, k;
+	int n = t->span;
+	LIFE_WORD* up;
+	LIFE_WORD* mid;
+	LIFE_WORD* down;
+	LIFE_WORD* out;
+	LIFE_WORD a, b, c, m;
+	LIFE_WORD u0, u1, d0, d1, m0, m1;
+	LIFE_WORD s0, s1, s2, c0, t0, t1;
+
+	for (y = 1; y <= t->h; ++y) {
+		up = src + (y - 1) * n;
+		mid = src + y * n;
+		down = src + (y + 1) * n;
+		out = dst + y * n;
+		for (k = 0; k < n; ++k) {
+			/* row above: 0..3 neighbors as <u1,u0> */
+			a = WEST_OF(up, k);
+			b = up[k];
+			c = EAST_OF(up, k, n);
+			u0 = a ^ b ^ c;
+			u1 = (a & b) | (c & (a ^ b));
+			/* row below: 0..3 neighbors as <d1,d0> */
+			a = WEST_OF(down, k);
+			b = down[k];
+			c = EAST_OF(down, k, n);
+			d0 = a ^ b ^ c;
+			d1 = (a & b) | (c & (a ^ b));
+			/* same row: 0..2 neighbors as <m1,m0> */
+			a = WEST_OF(mid, k);
+			c = EAST_OF(mid, k, n);
+			m0 = a ^ c;
+			m1 = a & c;
+			/* total, modulo 8, as <s2,s1,s0> */
+			s0 = u0 ^ d0 ^ m0;
+			c0 = (u0 & d0) | (m0 & (u0 ^ d0));
+			t0 = u1 ^ d1 ^ m1;
+			t1 = (u1 & d1) | (m1 & (u1 ^ d1));
+			s1 = t0 ^ c0;
+			s2 = t1 ^ (t0 & c0);
+			/* born with 3, survive with 2 or 3 */
+			m = inside_mask(k, t->w);
+			out[k] = ((~s2 & s1 & (s0 | mid[k])) & m) | (out[k] & ~m);
+		}
+	}
+}
+
+void
+wrap_halo(TILE* t, LIFE_WORD* b)
+/* fill the halo of a tile covering the whole grid from its own edges */
+{
+	int x, y;
+
+	for (x = 1; x <= t->w; ++x) {
+		set_board_bit(t, b, x, 0, BOARD_BIT(t, b, x, t->h));
+		set_board_bit(t, b, x, t->h + 1, BOARD_BIT(t, b, x, 1));
+	}
+	for (y = 0; y <= t->h + 1; ++y) {
+		set_board_bit(t, b, 0, y, BOARD_BIT(t, b, t->w, y));
+		set_board_bit(t, b, t->w + 1, y, BOARD_BIT(t, b, 1, y));
+	}
+}
+
+CONS*
+pack_edge(TILE* t, LIFE_WORD* b, int x, int y, int dx, int dy, int n)
+/* encode <n> cells starting at <x>,<y> in steps of <dx>,<dy> */
+{
+	CONS* q = cons(NIL, NIL);
+	int i, k, bits;
+
+	for (i = 0; i < n; i += EDGE_BITS) {
+		bits = 0;
+		for (k = 0; (k < EDGE_BITS) && (i + k < n); ++k) {
+			bits |= BOARD_BIT(t, b, x, y) << k;
+			x += dx;
+			y += dy;
+		}
+		CQ_PUT(q, cons(NUMBER(bits), NIL));
+	}
+	return CQ_PEEK(q);
+}
+
+void
+unpack_edge(TILE* t, LIFE_WORD* b, int x, int y, int dx, int dy, int n, CONS* edge)
+/* decode <n> cells from <edge> starting at <x>,<y> in steps of <dx>,<dy> */
+{
+	int i, k, bits;
+
+	for (i = 0; (i < n) && !nilp(edge); i += EDGE_BITS) {
+		bits = MK_INT(car(edge));
+		for (k = 0; (k < EDGE_BITS) && (i + k < n); ++k) {
+			set_board_bit(t, b, x, y, (bits >> k) & 1);
+			x += dx;
+			y += dy;
+		}
+		edge = cdr(edge);
+	}
+}
+
+void
+send_edge(CONFIG* cfg, TILE* to, CONS* side, CONS* edge, int gen)
+{
+	CONS* msg;
+
+	msg = NIL;
+	msg = map_put(msg, edge_symbol, edge);
+	msg = map_put(msg, side_symbol, side);
+	msg = map_put(msg, gen_symbol, NUMBER(gen));
+	CFG_SEND(cfg, to->actor, msg);
+}
+
+void
+send_edges(CONFIG* cfg, TILE* t)
+/* send the edges of <t> to each neighbor, naming the side of the halo it fills */
+{
+	int i = t->x0 / tile_size;
+	int j = t->y0 / tile_size;
+	LIFE_WORD* b = t->board[t->gen & 1];
+	int w = t->w;
+	int h = t->h;
+
+	send_edge(cfg, TILE_AT(i, j - 1), south_symbol, pack_edge(t, b, 1, 1, 1, 0, w), t->gen);
+	send_edge(cfg, TILE_AT(i, j + 1), north_symbol, pack_edge(t, b, 1, h, 1, 0, w), t->gen);
+	send_edge(cfg, TILE_AT(i - 1, j), east_symbol, pack_edge(t, b, 1, 1, 0, 1, h), t->gen);
+	send_edge(cfg, TILE_AT(i + 1, j), west_symbol, pack_edge(t, b, w, 1, 0, 1, h), t->gen);
+	send_edge(cfg, TILE_AT(i - 1, j - 1), south_east_symbol, pack_edge(t, b, 1, 1, 1, 0, 1), t->gen);
+	send_edge(cfg, TILE_AT(i + 1, j - 1), south_west_symbol, pack_edge(t, b, w, 1, 1, 0, 1), t->gen);
+	send_edge(cfg, TILE_AT(i - 1, j + 1), north_east_symbol, pack_edge(t, b, 1, h, 1, 0, 1), t->gen);
+	send_edge(cfg, TILE_AT(i + 1, j + 1), north_west_symbol, pack_edge(t, b, w, h, 1, 0, 1), t->gen);
+}
+
+void
+fill_halo(TILE* t, LIFE_WORD* b, CONS* side, CONS* edge)
+{
+	if (side == north_symbol) {
+		unpack_edge(t, b, 1, 0, 1, 0, t->w, edge);
+	} else if (side == south_symbol) {
+		unpack_edge(t, b, 1, t->h + 1, 1, 0, t->w, edge);
+	} else if (side == west_symbol) {
+		unpack_edge(t, b, 0, 1, 0, 1, t->h, edge);
+	} else if (side == east_symbol) {
+		unpack_edge(t, b, t->w + 1, 1, 0, 1, t->h, edge);
+	} else if (side == north_west_symbol) {
+		unpack_edge(t, b, 0, 0, 1, 0, 1, edge);
+	} else if (side == north_east_symbol) {
+		unpack_edge(t, b, t->w + 1, 0, 1, 0, 1, edge);
+	} else if (side == south_west_symbol) {
+		unpack_edge(t, b, 0, t->h + 1, 1, 0, 1, edge);
+	} else if (side == south_east_symbol) {
+		unpack_edge(t, b, t->w + 1, t->h + 1, 1, 0, 1, edge);
+	}
+}
+
+/**
+tile_actor(gen:<gen>, side:<side>, edge:<edge>){tile:<tile>} =
+	IF equal?(<gen>, _)
+		send_edges(<tile>)
+	ELSE
+		fill_halo(board(<tile>, <gen>), <side>, <edge>)
+		WHILE complete?(halo(<tile>, gen(<tile>))) AND preceed?(gen(<tile>), <limit>)
+			tile_step(<tile>)
+			send_edges(<tile>)
+**/
+BEH_DECL(tile_actor)
+{
+	CONS* msg = WHAT;
+	CONS* gen = map_get_def(msg, gen_symbol, NIL);
+	CONS* state = MINE;
+	TILE* t = &tiles[MK_INT(map_get(state, tile_symbol))];
+	int p;
+
+	DBUG_ENTER("tile_actor");
+	DBUG_PRINT("", ("tile=(%d,%d) gen=%d", t->x0, t->y0, t->gen));
+	if (nilp(gen)) {
+		send_edges(CFG, t);
+		DBUG_RETURN;
+	}
+	p = MK_INT(gen) & 1;
+	fill_halo(t, t->board[p], map_get(msg, side_symbol), map_get(msg, edge_symbol));
+	--t->need[p];
+	while ((t->need[t->gen & 1] == 0) && (t->gen < gen_limit)) {
+		p = t->gen & 1;
+		tile_step(t, t->board[p], t->board[!p]);
+		t->need[p] = 8;
+		++t->gen;
+		send_edges(CFG, t);
+	}
+	DBUG_RETURN;
+}
+
+void
+alloc_tiles()
+{
+	int i, j, x, y;
+	TILE* t;
+
+	DBUG_ENTER("alloc_tiles");
+	tiles_x = (grid_w + tile_size - 1) / tile_size;
+	tiles_y = (grid_h + tile_size - 1) / tile_size;
+	DBUG_PRINT("", ("%dx%d tiles of %d", tiles_x, tiles_y, tile_size));
+	tiles = NEWxN(TILE, tiles_x * tiles_y);
+	for (j = 0; j < tiles_y; ++j) {
+		for (i = 0; i < tiles_x; ++i) {
+			t = TILE_AT(i, j);
+			t->x0 = i * tile_size;
+			t->y0 = j * tile_size;
+			t->w = ((t->x0 + tile_size <= grid_w) ? tile_size : (grid_w - t->x0));
+			t->h = ((t->y0 + tile_size <= grid_h) ? tile_size : (grid_h - t->y0));
+			t->span = (t->w + 2 + LIFE_BITS - 1) / LIFE_BITS;
+			t->gen = 0;
+			t->need[0] = 8;
+			t->need[1] = 8;
+			t->board[0] = NEWxN(LIFE_WORD, t->span * (t->h + 2));
+			t->board[1] = NEWxN(LIFE_WORD, t->span * (t->h + 2));
+			t->actor = NIL;
+		}
+	}
+	/* place the pattern in the middle of the grid */
+	for (y = 0; y < pattern_h; ++y) {
+		for (x = 0; x < pattern_w; ++x) {
+			i = (grid_w - pattern_w) / 2 + x;
+			j = (grid_h - pattern_h) / 2 + y;
+			if ((i >= 0) && (i < grid_w) && (j >= 0) && (j < grid_h)) {
+				t = TILE_AT(i / tile_size, j / tile_size);
+				set_board_bit(t, t->board[0], i - t->x0 + 1, j - t->y0 + 1,
+					(get_pattern_value(x, y) == FULL));
+			}
+		}
+	}
+	DBUG_RETURN;
+}
+
+CONFIG*
+init_tiles(int limit)
+{
+	int i;
+	CONFIG* cfg;
+
+	DBUG_ENTER("init_tiles");
+	alloc_tiles();
+	gen_symbol = ATOM("gen");
+	side_symbol = ATOM("side");
+	edge_symbol = ATOM("edge");
+	tile_symbol = ATOM("tile");
+	north_symbol = ATOM("north");
+	south_symbol = ATOM("south");
+	east_symbol = ATOM("east");
+	west_symbol = ATOM("west");
+	north_east_symbol = ATOM("north-east");
+	north_west_symbol = ATOM("north-west");
+	south_east_symbol = ATOM("south-east");
+	south_west_symbol = ATOM("south-west");
+	cfg = new_configuration(16 * tiles_x * tiles_y + 1000);
+	gen_limit = limit;
+	for (i = 0; i < tiles_x * tiles_y; ++i) {
+		tiles[i].actor = CFG_ACTOR(cfg, tile_actor,
+			map_put(NIL, tile_symbol, NUMBER(i)));
+		cfg_add_gc_root(cfg, tiles[i].actor);
+	}
+	DBUG_RETURN cfg;
+}
+
+void
+print_tiles()
+{
+	int x, y, n;
+
+	n = 0;
+	for (y = 0; y < grid_h; ++y) {
+		for (x = 0; x < grid_w; ++x) {
+			if (get_tile_value(x, y) == FULL) {
+				++n;
+			}
+			if (!headless && (grid_w <= 80)) {
+				printf(" %c", get_tile_value(x, y));
+			}
+		}
+		if (!headless && (grid_w <= 80)) {
+			printf("\n");
+		}
+	}
+	printf("Population %d\n", n);
+}
+
+void
+test_tiles(int counter)
+{
+	int i;
+	int n;
+	CONFIG* cfg;
+	clock_t start;
+
+	DBUG_ENTER("test_tiles");
+	TRACE(printf("--test_tiles--\n"));
+	cfg = init_tiles(counter - 1);
+	TRACE(printf("Grid %dx%d, %d tiles of %dx%d\n",
+		grid_w, grid_h, tiles_x * tiles_y, tile_size, tile_size));
+	for (i = 0; i < tiles_x * tiles_y; ++i) {
+		CFG_SEND(cfg, tiles[i].actor, NIL);
+	}
+	start = clock();
+	do {
+		n = run_configuration(cfg, LIFE_BATCH);
+		note_cell_usage();
+		cfg_force_gc(cfg);
+	} while ((n == 0) && (cfg->q_count > 0));
+	if (cfg->q_count > 0) {
+		TRACE(printf("queue length %d with %d budget remaining\n", cfg->q_count, n));
+	}
+	TRACE(printf("Generation %d\n", tiles[0].gen));
+	print_tiles();
+	if (headless) {
+		report_benchmark(cfg, tiles[0].gen, start);
+	}
+
+	report_actor_usage(cfg);
+	DBUG_RETURN;
+}
+
+void
+test_sliced(int counter)
+/* step the whole grid as one tile, without actors, as a baseline */
+{
+	TILE* t;
+	clock_t start;
+	int p;
+
+	DBUG_ENTER("test_sliced");
+	TRACE(printf("--test_sliced--\n"));
+	tile_size = ((grid_w > grid_h) ? grid_w : grid_h);
+	alloc_tiles();
+	t = &tiles[0];
+	TRACE(printf("Grid %dx%d, %d-bit words\n", grid_w, grid_h, LIFE_BITS));
+	start = clock();
+	while (t->gen < counter - 1) {
+		p = t->gen & 1;
+		wrap_halo(t, t->board[p]);
+		tile_step(t, t->board[p], t->board[!p]);
+		++t->gen;
+	}
+	TRACE(printf("Generation %d\n", t->gen));
+	print_tiles();
+	report_benchmark(NULL, t->gen, start);
+	DBUG_RETURN;
+}
+
 void
 test_life(int counter)
 {
 	int n;
 	CONFIG* cfg;
+	clock_t start;
 
 	DBUG_ENTER("test_life");
 	TRACE(printf("--test_life--\n"));
 	cfg = init_life();
 
-	TRACE(printf("Initial Grid\n"));
-	print_grid();
+	if (!headless) {
+		TRACE(printf("Initial Grid\n"));
+		print_grid();
+	}
 	
+	start = clock();
 	for (n = 1; n < counter; ++n) {
 		life_tick(cfg);
-		TRACE(printf("Generation %d\n", n));
-		print_grid();
+		note_cell_usage();
+		if (!headless) {
+			TRACE(printf("Generation %d\n", n));
+			print_grid();
+		}
+	}
+	if (headless) {
+		report_benchmark(cfg, counter - 1, start);
 	}
 
 	report_actor_usage(cfg);
@@ -430,7 +1143,7 @@ void
 usage(void)
 {
 	fprintf(stderr, "\
-usage: %s [-n count] [-# dbug]\n",
+usage: %s [-bq] [-n count] [-x width] [-y height] [-T tile] [-# dbug] [pattern]\n",
 		_Program);
 	exit(EXIT_FAILURE);
 }
@@ -446,12 +1159,21 @@ main(int argc, char** argv)
 {
 	int c;
 	int counter = 35;
+	BOOL tiled = FALSE;
+	BOOL sliced = FALSE;
+	BOOL wide = FALSE;
+	BOOL high = FALSE;
 
 	DBUG_ENTER("main");
 	DBUG_PROCESS(argv[0]);
-	while ((c = getopt(argc, argv, "n:#:V")) != EOF) {
+	while ((c = getopt(argc, argv, "bqn:x:y:T:#:V")) != EOF) {
 		switch(c) {
+		case 'b':	sliced = TRUE;			break;
+		case 'q':	headless = TRUE;		break;
 		case 'n':	counter = atoi(optarg);	break;
+		case 'x':	grid_w = atoi(optarg);	tiled = wide = TRUE;	break;
+		case 'y':	grid_h = atoi(optarg);	tiled = high = TRUE;	break;
+		case 'T':	tile_size = atoi(optarg);	tiled = TRUE;	break;
 		case '#':	DBUG_PUSH(optarg);		break;
 		case 'V':	banner();				exit(EXIT_SUCCESS);
 		case '?':							usage();
@@ -460,8 +1182,30 @@ main(int argc, char** argv)
 	}
 	banner();
 
-	test_life(counter);	/* this test involves running the dispatch loop */
-
-	report_cons_stats();
+	if (optind < argc) {
+		if (!load_pattern(argv[optind])) {
+			exit(EXIT_FAILURE);
+		}
+		tiled = TRUE;			/* the cell-per-actor grid is fixed at 8x8 */
+		if (!wide) {
+			grid_w = 2 * pattern_w;		/* room to grow */
+		}
+		if (!high) {
+			grid_h = 2 * pattern_h;
+		}
+	}
+	if ((grid_w < 1) || (grid_h < 1) || (tile_size < 1)) {
+		usage();
+	}
+	if (sliced) {
+		test_sliced(counter);	/* no cells are used, so there are no stats */
+	} else {
+		if (tiled) {
+			test_tiles(counter);
+		} else {
+			test_life(counter);	/* this test involves running the dispatch loop */
+		}
+		report_cons_stats();
+	}
 	DBUG_RETURN (exit(EXIT_SUCCESS), 0);
 }
@@ -0,0 +1,696 @@
+/*
+ * pack.c -- Compact binary serialization of cons graphs
+ *
+ * A packed stream is:
+ *
+ *	'A' 'B' 'E' <version> <cell-count> <root> { <first> <rest> }...
+ *
+ * Each value is a variable-length word.  The first byte holds a 3-bit
+ * tag and the low 4 bits of the payload, the rest of the payload
+ * follows 7 bits per byte, low-order first.  Cells are numbered in the
+ * order they are first reached, and always referred to by number, so
+ * shared structure and cycles are preserved.  Each atom is spelled out
+ * the first time it appears in a stream, and referred to by number
+ * after that.  Actor behaviors and other function references are
+ * written as indexes into a table filled by pack_register_ref(), so a
+ * stream can be read by another process running the same program (even
+ * if it is loaded at a different address), and a damaged stream can
+ * never produce a pointer to arbitrary code.  Other raw words are not
+ * written at all, so pack_cons() refuses a graph that holds one.
+ *
+ * Decoding allocates all of the cells in one batch, then fills them
+ * in, so the cost is linear in the size of the stream.  Counts read
+ * from the stream are checked against the number of bytes left to
+ * read (every cell takes at least two bytes, every character of an
+ * atom one), so a damaged stream is rejected before it can cause a
+ * huge allocation.  A stream of unknown length is assumed to hold no
+ * more than PACK_MAX_INPUT bytes.
+ *
+ * NOTE: numbers and function references share one representation
+ *       (see NUMBER_IS_FUNC), so a function reference stored anywhere
+ *       other than an actor's behavior is written as a number, unless
+ *       it has been registered with pack_register_ref().  A behavior
+ *       must always be registered.
+ *
+ * Copyright 2009 Dale Schumacher.  ALL RIGHTS RESERVED.
+ */
+#include "pack.h"
+#include "abe.h"
+
+#include "dbug.h"
+DBUG_UNIT("pack");
+
+#define	PACK_VERSION	2
+#define	PACK_MAX_INPUT	((size_t)1 << 26)	/* longest stream of unknown length */
+
+#define	PK_CONST	0		/* NIL, FALSE or TRUE */
+#define	PK_NUMBER	1		/* signed number (zig-zag encoded) */
+#define	PK_CELL		2		/* cell reference */
+#define	PK_ACTOR	3		/* actor reference */
+#define	PK_ATOM		4		/* atom reference, spelled out on first use */
+#define	PK_BEH		5		/* registered behavior */
+#define	PK_REF		6		/* registered function reference */
+#define	PK_WORD		7		/* count or length (never a value) */
+
+#define	PK_NIL		0
+#define	PK_FALSE	1
+#define	PK_TRUE		2
+
+#define	PK_ACTOR_CELL	0x01		/* cell is referenced as an actor */
+
+static CONS**	pack_refs = NULL;		/* registered function references */
+static int		pack_ref_cnt = 0;
+static int		pack_ref_max = 0;
+
+void
+pack_register_ref(CONS* ref)
+/* register a behavior or function reference, so it can be written by index */
+{
+	if (pack_ref_cnt >= pack_ref_max) {
+		CONS** p;
+
+		pack_ref_max = (pack_ref_max ? (pack_ref_max * 2) : 16);
+		p = NEWxN(CONS*, pack_ref_max);
+		assert(p != NULL);
+		if (pack_refs != NULL) {
+			memcpy(p, pack_refs, sizeof(CONS*) * pack_ref_cnt);
+			free(pack_refs);
+		}
+		pack_refs = p;
+	}
+	pack_refs[pack_ref_cnt++] = ref;
+}
+
+static ulint
+zig_zag(WORD n)
+{
+	return ((n < 0) ? ((~(ulint)n << 1) | 1) : ((ulint)n << 1));
+}
+
+static WORD
+zag_zig(ulint u)
+{
+	return ((u & 1) ? (WORD)~(u >> 1) : (WORD)(u >> 1));
+}
+
+/*
+ * Encoder
+ */
+typedef struct pack_writer PACK_WRITER;
+struct pack_writer {
+	void		(*emit)(char c, void* ctx);
+	void*		ctx;
+	HTAB*		cell_index;		/* cell -> NUMBER(index) */
+	HTAB*		atom_index;		/* atom -> NUMBER(index) */
+	HTAB*		ref_index;		/* registered ref -> NUMBER(index) */
+	CONS**		cell;			/* cells, in index order */
+	char*		flags;			/* PK_* flags for each cell */
+	int			cell_cnt;
+	int			cell_max;
+	int			atom_cnt;
+};
+
+static void
+pack_word(PACK_WRITER* w, int tag, ulint payload)
+{
+	int b;
+
+	b = tag | (int)((payload & 0x0F) << 3);
+	payload >>= 4;
+	while (payload != 0) {
+		(*w->emit)((char)(b | 0x80), w->ctx);
+		b = (int)(payload & 0x7F);
+		payload >>= 7;
+	}
+	(*w->emit)((char)b, w->ctx);
+}
+
+static void
+pack_visit(PACK_WRITER* w, CONS* value)
+/* assign an index to <value>'s cell, if it refers to one not yet seen */
+{
+	CONS* cell;
+	CONS* index;
+
+	if (nilp(value) || boolp(value)) {
+		return;
+	}
+	if (actorp(value)) {
+		cell = MK_CONS(value);
+	} else if (consp(value)) {
+		cell = value;
+	} else {
+		return;
+	}
+	index = htab_get(w->cell_index, cell, NULL, NULL);
+	if (index == NULL) {
+		if (w->cell_cnt >= w->cell_max) {
+			CONS** p = NEWxN(CONS*, w->cell_max * 2);
+			char* f = NEWxN(char, w->cell_max * 2);
+
+			assert((p != NULL) && (f != NULL));
+			memcpy(p, w->cell, sizeof(CONS*) * w->cell_cnt);
+			memcpy(f, w->flags, sizeof(char) * w->cell_cnt);
+			free(w->cell);
+			free(w->flags);
+			w->cell = p;
+			w->flags = f;
+			w->cell_max *= 2;
+		}
+		index = NUMBER(w->cell_cnt);
+		htab_put(w->cell_index, cell, NULL, index);
+		w->cell[w->cell_cnt] = cell;
+		w->flags[w->cell_cnt] = 0;
+		++w->cell_cnt;
+	}
+	if (actorp(value)) {
+		w->flags[MK_INT(index)] |= PK_ACTOR_CELL;
+	}
+}
+
+static void
+pack_value(PACK_WRITER* w, CONS* value, BOOL is_beh)
+{
+	CONS* index;
+
+	if (nilp(value)) {
+		pack_word(w, PK_CONST, PK_NIL);
+	} else if (value == FALSE) {
+		pack_word(w, PK_CONST, PK_FALSE);
+	} else if (value == TRUE) {
+		pack_word(w, PK_CONST, PK_TRUE);
+	} else if (actorp(value)) {
+		index = htab_get(w->cell_index, MK_CONS(value), NULL, NULL);
+		assert(index != NULL);
+		pack_word(w, PK_ACTOR, (ulint)MK_INT(index));
+	} else if (consp(value)) {
+		index = htab_get(w->cell_index, value, NULL, NULL);
+		assert(index != NULL);
+		pack_word(w, PK_CELL, (ulint)MK_INT(index));
+	} else if (atomp(value)) {
+		index = htab_get(w->atom_index, value, NULL, NULL);
+		if (index != NULL) {
+			pack_word(w, PK_ATOM, (ulint)MK_INT(index));
+		} else {
+			char* s = atom_str(value);
+			size_t n = strlen(s);
+
+			htab_put(w->atom_index, value, NULL, NUMBER(w->atom_cnt));
+			pack_word(w, PK_ATOM, (ulint)w->atom_cnt++);
+			pack_word(w, PK_WORD, (ulint)n);
+			while (n-- > 0) {
+				(*w->emit)(*s++, w->ctx);
+			}
+		}
+	} else if (is_beh) {
+		index = htab_get(w->ref_index, value, NULL, NULL);
+		assert(index != NULL);
+		pack_word(w, PK_BEH, (ulint)MK_INT(index));
+	} else if ((index = htab_get(w->ref_index, value, NULL, NULL)) != NULL) {
+		pack_word(w, PK_REF, (ulint)MK_INT(index));
+	} else {
+		assert(numberp(value));
+		pack_word(w, PK_NUMBER, zig_zag(as_word(value) >> 2));
+	}
+}
+
+static BOOL
+pack_portable(PACK_WRITER* w, CONS* value, BOOL is_beh)
+/* TRUE if pack_value() can write <value> */
+{
+	if (nilp(value) || boolp(value) || actorp(value) || consp(value) || atomp(value)) {
+		return TRUE;
+	}
+	if (htab_get(w->ref_index, value, NULL, NULL) != NULL) {
+		return TRUE;
+	}
+	if (!is_beh && numberp(value)) {
+		return TRUE;
+	}
+	DBUG_PRINT("", ("unregistered %s %p", (is_beh ? "behavior" : "word"), value));
+	return FALSE;
+}
+
+BOOL
+pack_cons(CONS* root, void (*emit)(char c, void* ctx), void* ctx)
+/* write the graph reachable from <root> to <emit>, FALSE (and nothing written) if it is not portable */
+{
+	PACK_WRITER w;
+	CONS* cell;
+	BOOL ok;
+	int i;
+
+	DBUG_ENTER("pack_cons");
+	w.emit = emit;
+	w.ctx = ctx;
+	w.cell_index = new_htab(0);
+	w.atom_index = new_htab(0);
+	w.ref_index = new_htab(pack_ref_cnt);
+	w.cell_max = 64;
+	w.cell = NEWxN(CONS*, w.cell_max);
+	w.flags = NEWxN(char, w.cell_max);
+	assert((w.cell != NULL) && (w.flags != NULL));
+	w.cell_cnt = 0;
+	w.atom_cnt = 0;
+	for (i = 0; i < pack_ref_cnt; ++i) {
+		htab_put(w.ref_index, pack_refs[i], NULL, NUMBER(i));
+	}
+	pack_visit(&w, root);
+	for (i = 0; i < w.cell_cnt; ++i) {	/* the cell array is the work queue */
+		cell = w.cell[i];
+		pack_visit(&w, car(cell));
+		pack_visit(&w, cdr(cell));
+	}
+	DBUG_PRINT("", ("%d cells", w.cell_cnt));
+	ok = pack_portable(&w, root, FALSE);
+	for (i = 0; (i < w.cell_cnt) && ok; ++i) {
+		cell = w.cell[i];
+		ok = pack_portable(&w, car(cell), ((w.flags[i] & PK_ACTOR_CELL) ? TRUE : FALSE));
+		if (ok) {
+			ok = pack_portable(&w, cdr(cell), FALSE);
+		}
+	}
+	if (ok) {
+		(*emit)('A', ctx);
+		(*emit)('B', ctx);
+		(*emit)('E', ctx);
+		(*emit)((char)PACK_VERSION, ctx);
+		pack_word(&w, PK_WORD, (ulint)w.cell_cnt);
+		pack_value(&w, root, FALSE);
+		for (i = 0; i < w.cell_cnt; ++i) {
+			cell = w.cell[i];
+			pack_value(&w, car(cell), ((w.flags[i] & PK_ACTOR_CELL) ? TRUE : FALSE));
+			pack_value(&w, cdr(cell), FALSE);
+		}
+	}
+	free(w.cell);
+	free(w.flags);
+	w.cell_index = free_htab(w.cell_index);
+	w.atom_index = free_htab(w.atom_index);
+	w.ref_index = free_htab(w.ref_index);
+	DBUG_RETURN ok;
+}
+
+/*
+ * Decoder
+ */
+typedef struct pack_reader PACK_READER;
+struct pack_reader {
+	int			(*read)(void* ctx);
+	void*		ctx;
+	size_t		left;			/* bytes that may still be read */
+	CONS**		cell;			/* cells, in index order */
+	int			cell_cnt;
+	CONS**		atom;			/* atoms, in index order */
+	int			atom_cnt;
+	int			atom_max;
+	BOOL		error;
+};
+
+static int
+unpack_byte(PACK_READER* r)
+/* read one byte, return EOF at the end of the stream or past its limit */
+{
+	if (r->left == 0) {
+		return EOF;
+	}
+	--r->left;
+	return (*r->read)(r->ctx);
+}
+
+static int
+unpack_word(PACK_READER* r, ulint* payload)
+/* read a tagged word, return its tag (or EOF) */
+{
+	int b;
+	int tag;
+	int shift;
+
+	b = unpack_byte(r);
+	if (b == EOF) {
+		r->error = TRUE;
+		return EOF;
+	}
+	tag = (b & 0x07);
+	*payload = (ulint)((b >> 3) & 0x0F);
+	shift = 4;
+	while (b & 0x80) {
+		b = unpack_byte(r);
+		if ((b == EOF) || (shift >= (int)(8 * sizeof(ulint)))) {
+			r->error = TRUE;
+			return EOF;
+		}
+		*payload |= ((ulint)(b & 0x7F) << shift);
+		shift += 7;
+	}
+	return tag;
+}
+
+static CONS*
+unpack_atom(PACK_READER* r, ulint index)
+{
+	ulint n;
+	char* s;
+	char* p;
+	CONS* atom;
+	int c;
+
+	if (index < (ulint)r->atom_cnt) {
+		return r->atom[index];
+	}
+	if ((index != (ulint)r->atom_cnt)
+	|| (unpack_word(r, &n) != PK_WORD)
+	|| (n > (ulint)r->left)) {
+		r->error = TRUE;
+		return NIL;
+	}
+	p = s = NEWxN(char, (size_t)n + 1);
+	if (s == NULL) {
+		r->error = TRUE;
+		return NIL;
+	}
+	while (n-- > 0) {
+		if ((c = unpack_byte(r)) == EOF) {
+			r->error = TRUE;
+			break;
+		}
+		*p++ = (char)c;
+	}
+	*p = '\0';
+	atom = ATOM(s);
+	free(s);
+	if (r->atom_cnt >= r->atom_max) {
+		CONS** q;
+
+		r->atom_max = (r->atom_max ? (r->atom_max * 2) : 64);
+		q = NEWxN(CONS*, r->atom_max);
+		if (q == NULL) {
+			r->error = TRUE;
+			return atom;
+		}
+		if (r->atom != NULL) {
+			memcpy(q, r->atom, sizeof(CONS*) * r->atom_cnt);
+			free(r->atom);
+		}
+		r->atom = q;
+	}
+	r->atom[r->atom_cnt++] = atom;
+	return atom;
+}
+
+static CONS*
+unpack_value(PACK_READER* r)
+{
+	ulint u;
+
+	switch (unpack_word(r, &u)) {
+	case PK_CONST:
+		if (u == PK_NIL) { return NIL; }
+		if (u == PK_FALSE) { return FALSE; }
+		if (u == PK_TRUE) { return TRUE; }
+		break;
+	case PK_NUMBER:
+		return MK_NUMBER(zag_zig(u));
+	case PK_CELL:
+		if (u < (ulint)r->cell_cnt) { return r->cell[u]; }
+		break;
+	case PK_ACTOR:
+		if (u < (ulint)r->cell_cnt) { return MK_ACTOR(r->cell[u]); }
+		break;
+	case PK_ATOM:
+		return unpack_atom(r, u);
+	case PK_BEH:
+	case PK_REF:
+		if (u < (ulint)pack_ref_cnt) { return pack_refs[u]; }
+		break;
+	}
+	r->error = TRUE;
+	return NIL;
+}
+
+static CONS*
+unpack_limit(int (*read)(void* ctx), void* ctx, size_t size)
+/* read a graph of no more than <size> bytes, return NULL if malformed */
+{
+	PACK_READER r;
+	CONS* root = NULL;
+	CONS* p;
+	ulint n;
+	int i;
+
+	DBUG_ENTER("unpack_limit");
+	r.read = read;
+	r.ctx = ctx;
+	r.left = size;
+	r.cell = NULL;
+	r.cell_cnt = 0;
+	r.atom = NULL;
+	r.atom_cnt = 0;
+	r.atom_max = 0;
+	r.error = FALSE;
+	if ((unpack_byte(&r) != 'A')
+	||  (unpack_byte(&r) != 'B')
+	||  (unpack_byte(&r) != 'E')
+	||  (unpack_byte(&r) != PACK_VERSION)
+	||  (unpack_word(&r, &n) != PK_WORD)
+	||  (n > (ulint)(((unsigned)-1) >> 1))
+	||  (n > (ulint)(r.left / 2))) {	/* each cell takes at least 2 bytes */
+		DBUG_PRINT("", ("bad header"));
+		DBUG_RETURN NULL;
+	}
+	r.cell_cnt = (int)n;
+	r.cell = NEWxN(CONS*, r.cell_cnt + 1);
+	if (r.cell == NULL) {
+		DBUG_PRINT("", ("%d cells", r.cell_cnt));
+		DBUG_RETURN NULL;
+	}
+	p = cons_list(r.cell_cnt, NIL);		/* allocate every cell at once */
+	for (i = 0; i < r.cell_cnt; ++i) {
+		r.cell[i] = p;
+		p = cdr(p);
+	}
+	root = unpack_value(&r);
+	for (i = 0; (i < r.cell_cnt) && (r.error == FALSE); ++i) {
+		rplaca(r.cell[i], unpack_value(&r));
+		rplacd(r.cell[i], unpack_value(&r));
+	}
+	if (r.error != FALSE) {
+		DBUG_PRINT("", ("malformed stream"));
+		root = NULL;
+	}
+	free(r.cell);
+	if (r.atom != NULL) {
+		free(r.atom);
+	}
+	DBUG_RETURN root;
+}
+
+CONS*
+unpack_cons(int (*read)(void* ctx), void* ctx)
+/* read a graph written by pack_cons(), return NULL if malformed */
+{
+	return unpack_limit(read, ctx, PACK_MAX_INPUT);
+}
+
+int
+pack_mem_read(void* ctx)
+{
+	PACK_MEM* mem = (PACK_MEM*)ctx;
+
+	if (mem->offset >= mem->size) {
+		return EOF;
+	}
+	return (unsigned char)mem->buf[mem->offset++];
+}
+
+void
+pack_file_emit(char c, void* ctx)
+{
+	fputc((unsigned char)c, (FILE*)ctx);
+}
+
+int
+pack_file_read(void* ctx)
+{
+	return fgetc((FILE*)ctx);
+}
+
+CONS*
+unpack_mem(char* buf, size_t size)
+{
+	PACK_MEM mem;
+
+	mem.buf = buf;
+	mem.size = size;
+	mem.offset = 0;
+	return unpack_limit(pack_mem_read, &mem, size);
+}
+
+CONS*
+unpack_file(FILE* f)
+/* read a graph from the rest of <f>, return NULL if malformed */
+{
+	long here;
+	long end;
+
+	if (((here = ftell(f)) < 0)
+	||  (fseek(f, 0L, SEEK_END) != 0)
+	||  ((end = ftell(f)) < here)
+	||  (fseek(f, here, SEEK_SET) != 0)) {
+		return unpack_cons(pack_file_read, f);	/* not seekable */
+	}
+	return unpack_limit(pack_file_read, f, (size_t)(end - here));
+}
+
+/*
+ * Configuration checkpoints
+ */
+BOOL
+pack_config(CONFIG* cfg, void (*emit)(char c, void* ctx), void* ctx)
+/* write the gc roots and pending (not delayed) messages of <cfg>, FALSE if not portable */
+{
+	CONS* msgs = NIL;
+	CONS* node;
+	CONS* entry;
+	BOOL ok;
+
+	DBUG_ENTER("pack_config");
+	node = CQ_PEEK(CONFIG_QUEUE(cfg));
+	while (!nilp(node)) {
+		entry = car(node);
+		msgs = cons(cons(car(entry), cdr(entry)), msgs);
+		node = cdr(node);
+	}
+	ok = pack_cons(cons(cfg->gc_root, reverse(msgs)), emit, ctx);
+	DBUG_RETURN ok;
+}
+
+int
+unpack_config(CONFIG* cfg, int (*read)(void* ctx), void* ctx)
+/* restore a checkpoint written by pack_config(), return the number of messages queued (or -1) */
+{
+	CONS* state;
+	CONS* p;
+	int n = 0;
+
+	DBUG_ENTER("unpack_config");
+	state = unpack_cons(read, ctx);
+	if ((state == NULL) || !consp(state) || nilp(state)) {
+		DBUG_RETURN -1;
+	}
+	for (p = car(state); !nilp(p); p = cdr(p)) {
+		cfg_add_gc_root(cfg, car(p));
+	}
+	for (p = cdr(state); !nilp(p); p = cdr(p)) {
+		CFG_SEND(cfg, car(car(p)), cdr(car(p)));
+		++n;
+	}
+	DBUG_RETURN n;
+}
+
+static
+BEH_DECL(pack_test_beh)
+{
+	DBUG_ENTER("pack_test_beh");
+	DBUG_RETURN;
+}
+
+static
+BEH_DECL(pack_stray_beh)	/* never registered */
+{
+	DBUG_ENTER("pack_stray_beh");
+	DBUG_RETURN;
+}
+
+void
+test_pack()
+{
+	SBUF* sbuf = new_sbuf(64);
+	CONFIG* cfg;
+	CONS* p;
+	CONS* q;
+	CONS* a;
+	int i;
+
+	DBUG_ENTER("test_pack");
+	TRACE(printf("--test_pack--\n"));
+
+	pack_cons(NUMBER(-42), sbuf_emit, sbuf);
+	assert(unpack_mem(sbuf->buf, sbuf->offset) == NUMBER(-42));
+	assert(unpack_mem(sbuf->buf, sbuf->offset - 1) == NULL);	/* truncated */
+	assert(unpack_mem("XYZ", 3) == NULL);
+	assert(unpack_mem("ABE\002\377\377\377\017\000", 9) == NULL);	/* too many cells */
+	assert(unpack_mem("ABE\002\007\004\377\377\377\017x", 11) == NULL);	/* atom too long */
+	assert(unpack_mem("ABE\002\000\007", 6) == NULL);	/* raw word */
+	assert(unpack_mem("ABE\002\017\003\375\377\377\017\000", 11) == NULL);	/* no such behavior */
+
+	p = cons(ATOM("x"), cons(NUMBER(1), cons(ATOM("x"), cons(TRUE, cons(FALSE, NIL)))));
+	p = cons(p, p);						/* shared sub-list */
+	clear_sbuf(sbuf);
+	pack_cons(p, sbuf_emit, sbuf);
+	q = unpack_mem(sbuf->buf, sbuf->offset);
+	assert(q != NULL);
+	assert(q != p);
+	assert(equal(p, q));
+	assert(car(q) == cdr(q));			/* sharing preserved */
+	assert(car(car(q)) == ATOM("x"));
+
+	p = cons(NUMBER(0), cons(NUMBER(1), NIL));
+	rplacd(cdr(p), p);					/* cycle */
+	clear_sbuf(sbuf);
+	pack_cons(p, sbuf_emit, sbuf);
+	q = unpack_mem(sbuf->buf, sbuf->offset);
+	assert(q != NULL);
+	assert(cdr(cdr(q)) == q);
+	assert(car(cdr(q)) == NUMBER(1));
+
+	pack_register_ref(MK_REF(pack_test_beh));
+	a = CFG_ACTOR(NULL, pack_test_beh, cons(MK_REF(pack_test_beh), NIL));
+	clear_sbuf(sbuf);
+	pack_cons(cons(a, a), sbuf_emit, sbuf);
+	q = unpack_mem(sbuf->buf, sbuf->offset);
+	assert(q != NULL);
+	assert(actorp(car(q)));
+	assert(car(q) == cdr(q));
+	assert(car(q) != a);
+	assert(_THIS(car(q)) == pack_test_beh);
+	assert(car(_MINE(car(q))) == MK_REF(pack_test_beh));
+
+	clear_sbuf(sbuf);
+	assert(pack_cons(CFG_ACTOR(NULL, pack_stray_beh, NIL), sbuf_emit, sbuf) == FALSE);
+	assert(sbuf->offset == 0);
+
+	p = NIL;
+	for (i = 0; i < 100000; ++i) {
+		p = cons(NUMBER(i - 50000), p);
+	}
+	clear_sbuf(sbuf);
+	pack_cons(p, sbuf_emit, sbuf);
+	DBUG_PRINT("", ("100000 numbers packed in %d bytes", (int)sbuf->offset));
+	assert(sbuf->offset < (100000 * 6));
+	q = unpack_mem(sbuf->buf, sbuf->offset);
+	assert(equal(p, q));
+
+	cfg = new_configuration(100);
+	cfg_add_gc_root(cfg, ATOM("root"));
+	CFG_SEND(cfg, a, NUMBER(1));
+	CFG_SEND(cfg, a, NUMBER(2));
+	clear_sbuf(sbuf);
+	pack_config(cfg, sbuf_emit, sbuf);
+	cfg = new_configuration(100);
+	{
+		PACK_MEM mem;
+
+		mem.buf = sbuf->buf;
+		mem.size = sbuf->offset;
+		mem.offset = 0;
+		assert(unpack_config(cfg, pack_mem_read, &mem) == 2);
+	}
+	assert(cfg->q_count == 2);
+	assert(car(cfg->gc_root) == ATOM("root"));
+	assert(_THIS(car(car(CQ_PEEK(CONFIG_QUEUE(cfg))))) == pack_test_beh);
+	assert(cdr(car(CQ_PEEK(CONFIG_QUEUE(cfg)))) == NUMBER(1));
+
+	sbuf = free_sbuf(sbuf);
+	DBUG_RETURN;
+}
@@ -0,0 +1,34 @@
+/*
+ * pack.h -- Compact binary serialization of cons graphs
+ *
+ * Copyright 2009 Dale Schumacher.  ALL RIGHTS RESERVED.
+ */
+#ifndef PACK_H
+#define PACK_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include "types.h"
+
+typedef struct pack_mem PACK_MEM;
+struct pack_mem {
+	char*		buf;		/* encoded bytes */
+	size_t		size;		/* number of bytes in <buf> */
+	size_t		offset;		/* read position */
+};
+
+void	pack_register_ref(CONS* ref);	/* behavior or function reference to write by index */
+BOOL	pack_cons(CONS* root, void (*emit)(char c, void* ctx), void* ctx);	/* FALSE if not portable */
+CONS*	unpack_cons(int (*read)(void* ctx), void* ctx);	/* NULL if malformed */
+int		pack_mem_read(void* ctx);		/* read from a PACK_MEM */
+void	pack_file_emit(char c, void* ctx);	/* write to a FILE* */
+int		pack_file_read(void* ctx);		/* read from a FILE* */
+CONS*	unpack_mem(char* buf, size_t size);
+CONS*	unpack_file(FILE* f);			/* NULL if malformed */
+
+BOOL	pack_config(CONFIG* cfg, void (*emit)(char c, void* ctx), void* ctx);
+int		unpack_config(CONFIG* cfg, int (*read)(void* ctx), void* ctx);
+
+void	test_pack();
+
+#endif /* PACK_H */
@@ -38,6 +38,7 @@ static char	_Copyright[] = "Copyright 2008-2009 Dale Schumacher";
 DBUG_UNIT("reduce");
 
 static CONFIG* reduce_cfg = NULL;
+static BOOL hash_cons_source = FALSE;	/* share identical source sub-trees */
 
 static CONS* undefined_symbol = NIL;
 static CONS* true_symbol = NIL;
@@ -57,6 +58,11 @@ static CONS* a_print = NIL;
 static CONS* a_sink = NIL;
 
 static CONS* eval_env = NIL;
+static HTAB* global_index = NULL;	/* symbol -> newest binding in eval_env */
+
+static CONS* a_lexref = NIL;	/* (<a_lexref> <depth> <index> . <name>) */
+static CONS* a_frame = NIL;		/* (<a_frame> <values> . <parent frame>) */
+static CONS* a_compiled = NIL;	/* (<a_compiled> <names> . <body>) */
 
 BEH_DECL(print_msg)
 {
@@ -132,10 +138,233 @@ BEH_DECL(apply_expr)
 	DBUG_RETURN;
 }
 
+/*
+ * Environments are assoc lists.  Bindings made in the global
+ * environment (eval_env and everything define links in after its
+ * "self") are also indexed by name in global_index, so a lookup scans
+ * only the local bindings in front of eval_env.
+ *
+ * A function body is compiled once, when its function form is first
+ * reduced.  References to the parameters of the function, and of the
+ * functions enclosing it, become lexical addresses: a frame depth and
+ * a slot index.  Each call puts a frame holding the argument list at
+ * the head of the environment, linked to the frame of the enclosing
+ * function.  The arguments of literal, template and # are not
+ * compiled, nor are self and become, which actor rebinds.  References
+ * inside an actor form to the variables outside it stay names, since
+ * define links its binding in right after the actor's self, between the
+ * reference and the enclosing frames.  Parameters are bound by name as
+ * well only when the body still names one of them, or mentions reduce
+ * or template and so may build code at run time.  A slot that was not
+ * supplied is looked up by name in the enclosing environment.  The
+ * operands of a template call are substituted as text, so a template
+ * turns the addresses in them back into names, and binds just those
+ * names to their values for the expansion.
+ */
+static CONS*
+env_lookup(CONS* env, CONS* name)
+/* return the value bound to <name> in <env>, or NULL if not found */
+{
+	CONS* binding;
+
+	while (consp(env) && !nilp(env)) {
+		if (env == eval_env) {
+			binding = htab_get(global_index, name, NULL, NIL);
+			return (nilp(binding) ? NULL : cdr(binding));
+		}
+		if (car(car(env)) == name) {
+			return cdr(car(env));
+		}
+		env = cdr(env);
+	}
+	return NULL;
+}
+
+static CONS*
+env_frame(CONS* env)
+/* return the nearest call frame in <env>, or NIL at global level */
+{
+	while (consp(env) && !nilp(env) && (env != eval_env)) {
+		if (car(car(env)) == a_frame) {
+			return car(env);
+		}
+		env = cdr(env);
+	}
+	return NIL;
+}
+
+static CONS*
+lex_lookup(CONS* env, CONS* ref)
+/* return the value at lexical address <ref> in <env> */
+{
+	int depth = MK_INT(car(cdr(ref)));
+	int index = MK_INT(car(cdr(cdr(ref))));
+	CONS* frame = env_frame(env);
+	CONS* slots;
+
+	while (!nilp(frame) && (depth-- > 0)) {
+		frame = cdr(cdr(frame));
+	}
+	if (!nilp(frame)) {
+		slots = car(cdr(frame));
+		while (consp(slots) && !nilp(slots)) {
+			if (index-- == 0) {
+				return car(slots);
+			}
+			slots = cdr(slots);
+		}
+	}
+	return env_lookup(env, cdr(cdr(cdr(ref))));		/* missing argument */
+}
+
+static int
+var_index(CONS* vars, CONS* name)
+/* return the slot index of <name> in <vars>, or -1 if not a parameter */
+{
+	int i;
+
+	if (atomp(vars)) {
+		return ((vars == name) ? 0 : -1);
+	}
+	for (i = 0; consp(vars) && !nilp(vars); ++i) {
+		if (car(vars) == name) {
+			return i;
+		}
+		vars = cdr(vars);
+	}
+	return -1;
+}
+
+static BOOL
+lex_named(CONS* body, CONS* vars)
+/* TRUE if compiled <body> names one of <vars>, or may build code at run time */
+{
+	if (atomp(body)) {
+		return ((body == ATOM("reduce")) || (body == ATOM("template"))
+			|| (var_index(vars, body) >= 0)) ? TRUE : FALSE;
+	}
+	while (consp(body) && !nilp(body) && (car(body) != a_lexref)) {
+		if (lex_named(car(body), vars)) {
+			return TRUE;
+		}
+		body = cdr(body);
+	}
+	return (atomp(body) ? lex_named(body, vars) : FALSE);
+}
+
+static CONS*
+lex_compile(CONS* expr, CONS* scope)
+/* replace references to variables in <scope> (innermost vars first) */
+{
+	CONS* head;
+	CONS* q;
+	CONS* p;
+	int depth;
+	int i;
+
+	if (atomp(expr)) {
+		if ((expr == self_symbol) || (expr == ATOM("become"))) {
+			return expr;
+		}
+		for (depth = 0, p = scope; !nilp(p); ++depth, p = cdr(p)) {
+			if ((i = var_index(car(p), expr)) >= 0) {
+				return cons(a_lexref, cons(NUMBER(depth), cons(NUMBER(i), expr)));
+			}
+		}
+		return expr;
+	}
+	if (!consp(expr) || nilp(expr)) {
+		return expr;
+	}
+	head = car(expr);
+	if (head == a_lexref) {
+		return lex_compile(cdr(cdr(cdr(expr))), scope);	/* substituted from elsewhere */
+	}
+	if (atomp(head) && (lex_compile(head, scope) == head)) {	/* not a local */
+		if ((head == ATOM("literal")) || (head == ATOM("template")) || (head == ATOM("#"))) {
+			return expr;
+		}
+		if ((head == ATOM("function")) && consp(cdr(expr)) && consp(cdr(cdr(expr)))) {
+			CONS* vars = car(cdr(expr));
+			CONS* body = car(cdr(cdr(expr)));
+
+			if (consp(body) && !nilp(body) && (car(body) == a_compiled)) {
+				body = cdr(cdr(body));		/* re-address for this scope */
+			}
+			body = lex_compile(body, cons(vars, scope));
+			body = cons(a_compiled, cons(lex_named(body, vars), body));
+			return cons(head, cons(vars, cons(body, cdr(cdr(cdr(expr))))));
+		}
+		if ((head == ATOM("define")) && consp(cdr(expr))) {
+			return cons(head, cons(car(cdr(expr)), lex_compile(cdr(cdr(expr)), scope)));
+		}
+		if (head == ATOM("actor")) {
+			return cons(head, lex_compile(cdr(expr), NIL));	/* new scope for define */
+		}
+	}
+	q = cons(NIL, NIL);
+	while (consp(expr) && !nilp(expr)) {
+		CQ_PUT(q, cons(lex_compile(car(expr), scope), NIL));
+		expr = cdr(expr);
+	}
+	if (!nilp(expr)) {
+		rplacd(cdr(q), expr);		/* improper tail */
+	}
+	return CQ_PEEK(q);
+}
+
+static CONS*
+lex_restore(CONS* expr, int nest, CONS* env, CONS** bound)
+/* replace addresses in <expr> by names, binding those from <env> in <bound> */
+{
+	CONS* head;
+	CONS* q;
+
+	if (!consp(expr) || nilp(expr)) {
+		return expr;
+	}
+	head = car(expr);
+	if (head == a_lexref) {
+		int depth = MK_INT(car(cdr(expr)));
+		CONS* value;
+
+		if (depth >= nest) {	/* not a parameter of a function inside <expr> */
+			if (nest > 0) {
+				expr = cons(a_lexref, cons(NUMBER(depth - nest), cdr(cdr(expr))));
+			}
+			value = lex_lookup(env, expr);
+			if (value != NULL) {
+				*bound = map_put(*bound, cdr(cdr(cdr(expr))), value);
+			}
+		}
+		return cdr(cdr(cdr(expr)));
+	}
+	if ((head == ATOM("function")) && consp(cdr(expr)) && consp(cdr(cdr(expr)))) {
+		CONS* body = car(cdr(cdr(expr)));
+
+		if (consp(body) && !nilp(body) && (car(body) == a_compiled)) {
+			body = cdr(cdr(body));		/* compiled again when reduced */
+		}
+		body = lex_restore(body, nest + 1, env, bound);
+		return cons(head, cons(car(cdr(expr)), cons(body, cdr(cdr(cdr(expr))))));
+	}
+	q = cons(NIL, NIL);
+	while (consp(expr) && !nilp(expr)) {
+		CQ_PUT(q, cons(lex_restore(car(expr), nest, env, bound), NIL));
+		expr = cdr(expr);
+	}
+	if (!nilp(expr)) {
+		rplacd(cdr(q), expr);		/* improper tail */
+	}
+	return CQ_PEEK(q);
+}
+
 /**
 reduce_expr(expr:<expr>, cont:<cont>, env:<env>){} =
 	IF symbol?(<expr>)
 		{expr:map(<env>, <expr>)} => <cont>
+	ELIF address?(<expr>)
+		{expr:frame(<env>, depth(<expr>))[index(<expr>)]} => <cont>
 	ELIF empty?(<expr>)
 		{expr:<expr>} => <cont>
 	ELSE
@@ -164,7 +393,7 @@ BEH_DECL(reduce_expr)
 	} else if (atomp(expr)) {
 		/* atomic symbol */
 		DBUG_PRINT("", ("atomic symbol"));
-		result = map_get(env, expr);
+		result = env_lookup(env, expr);
 		if (result == NULL) {
 			DBUG_PRINT("", ("env=%s", cons_to_str(env)));
 			SEND(an_error, cons(ATOM("reduce: undefined symbol"), expr));
@@ -174,6 +403,14 @@ BEH_DECL(reduce_expr)
 		/* empty list */
 		DBUG_PRINT("", ("empty list"));
 		result = expr;
+	} else if (consp(expr) && (car(expr) == a_lexref)) {
+		/* lexical address */
+		DBUG_PRINT("", ("lexical address"));
+		result = lex_lookup(env, expr);
+		if (result == NULL) {
+			SEND(an_error, cons(ATOM("reduce: undefined symbol"), cdr(cdr(cdr(expr)))));
+			result = undefined_symbol;
+		}
 	} else if (consp(expr)) {
 		/* evaluate first element to determine the actor to apply */
 		CONS* state;
@@ -668,6 +905,9 @@ extend_env(CONS* env, CONS* name, CONS* value)
 	/* link in new binding to immediately follow "self" */
 	binding = cons(name, value);
 	rplacd(env, cons(binding, cdr(env)));
+	if (env == eval_env) {
+		htab_put(global_index, name, NULL, binding);
+	}
 	return binding;
 }
 
@@ -861,6 +1101,7 @@ BEH_DECL(reduce_product)
 
 /**
 template(expr:<expr>, cont:<cont>, env:<env>){vars:<vars>, body:<body>} =
+	<expr> := names(<expr>), <env> := bind(names(<expr>), <env>)
 	{expr:replace(<body>, map_def(<vars>, <expr>)), cont:<cont>, env:<env>} => reduce
 **/
 BEH_DECL(template)
@@ -874,6 +1115,7 @@ BEH_DECL(template)
 	CONS* body = map_get(state, ATOM("body"));
 
 	DBUG_ENTER("template");
+	expr = lex_restore(expr, 0, env, &env);		/* operands are substituted as text */
 	expr = replace(body, map_def(NIL, vars, expr));		/* FIXME: check for binding to a single symbol, like eval_function */
 	DBUG_PRINT("", ("expr=%s", cons_to_str(expr)));
 	msg = NIL;
@@ -909,11 +1151,13 @@ BEH_DECL(reduce_template)
 }
 
 /**
-eval_function(expr:<expr>){vars:<vars>, body:<body>, cont:<cont>, env:<env>} =
-	IF list?(<vars>)
-		<env> := map_put_all(<env>, map_def(<vars>, <expr>))
-	ELIF atom?(<vars>)
-		<env> := map_put(<env>, <vars>, <expr>)
+eval_function(expr:<expr>){vars:<vars>, body:<body>, names:<names>, cont:<cont>, env:<env>} =
+	IF <names>
+		IF list?(<vars>)
+			<env> := map_put_all(<env>, map_def(<vars>, <expr>))
+		ELIF atom?(<vars>)
+			<env> := map_put(<env>, <vars>, <expr>)
+	<env> := prepend(frame(<expr>, frame(<env>)), <env>)
 	{expr:<body>, cont:<cont>, env:<env>} => reduce
 **/
 BEH_DECL(eval_function)
@@ -923,19 +1167,28 @@ BEH_DECL(eval_function)
 	CONS* state = MINE;
 	CONS* vars = map_get(state, ATOM("vars"));
 	CONS* body = map_get(state, ATOM("body"));
+	CONS* names = map_get(state, ATOM("names"));
 	CONS* cont = map_get(state, cont_symbol);
 	CONS* env = map_get(state, env_symbol);
+	CONS* frame;
 
 	DBUG_ENTER("eval_function");
 	DBUG_PRINT("", ("vars=%s", cons_to_str(vars)));
 	DBUG_PRINT("", ("expr=%s", cons_to_str(expr)));
+	frame = env_frame(env);		/* frame of the enclosing function */
 	if (consp(vars)) {
-		/* bind vars to values */
-		env = map_def(env, vars, expr);
+		if (names) {
+			/* bind vars to values */
+			env = map_def(env, vars, expr);
+		}
 	} else if (atomp(vars)) {
-		/* bind single var to list of values */
-		env = map_put(env, vars, expr);
+		if (names) {
+			/* bind single var to list of values */
+			env = map_put(env, vars, expr);
+		}
+		expr = cons(expr, NIL);
 	}
+	env = map_put(env, a_frame, cons(expr, frame));	/* slots for lexical addresses */
 	DBUG_PRINT("", ("body=%s", cons_to_str(body)));
 	msg = NIL;
 	msg = map_put(msg, env_symbol, env);
@@ -946,8 +1199,8 @@ BEH_DECL(eval_function)
 }
 
 /**
-function(expr:<expr>, cont:<cont>, env:<dyn>){vars:<vars>, body:<body>, env:<lex>} =
-	<apply> := actor(eval_function, {vars:<vars>, body:<body>, cont:<cont>, env:<lex>})
+function(expr:<expr>, cont:<cont>, env:<dyn>){vars:<vars>, body:<body>, names:<names>, env:<lex>} =
+	<apply> := actor(eval_function, {vars:<vars>, body:<body>, names:<names>, cont:<cont>, env:<lex>})
 	{expr:<expr>, cont:<apply>, env:<dyn>} => reduce_args
 **/
 BEH_DECL(function)
@@ -966,6 +1219,9 @@ BEH_DECL(function)
 	state = NIL;
 	state = map_put(state, env_symbol, lex);
 	state = map_put(state, cont_symbol, cont);
+	if (map_get(MINE, ATOM("names"))) {
+		state = map_put(state, ATOM("names"), TRUE);
+	}
 	state = map_put(state, ATOM("body"), body);
 	state = map_put(state, ATOM("vars"), vars);
 	apply = ACTOR(eval_function, state);
@@ -979,7 +1235,9 @@ BEH_DECL(function)
 
 /**
 reduce_function(expr:<expr>, cont:<cont>, env:<env>){} =
-	{expr:actor(function, {vars:first(<expr>), body:second(<expr>), env:<env>})} => <cont>
+	<body> := compile(second(<expr>), first(<expr>))
+	<names> := named?(<body>, first(<expr>))
+	{expr:actor(function, {vars:first(<expr>), body:<body>, names:<names>, env:<env>})} => <cont>
 **/
 BEH_DECL(reduce_function)
 {
@@ -990,10 +1248,25 @@ BEH_DECL(reduce_function)
 	CONS* state;
 	CONS* actor;
 
+	CONS* body;
+	CONS* names;
+
 	DBUG_ENTER("reduce_function");
+	body = car(cdr(expr));
+	if (consp(body) && !nilp(body) && (car(body) == a_compiled)) {
+		names = car(cdr(body));		/* compiled with an enclosing function */
+		body = cdr(cdr(body));
+	} else {
+		body = lex_compile(body, cons(car(expr), NIL));
+		names = lex_named(body, car(expr));
+	}
+	DBUG_PRINT("", ("body=%s", cons_to_str(body)));
 	state = NIL;
 	state = map_put(state, env_symbol, env);
-	state = map_put(state, ATOM("body"), car(cdr(expr)));
+	if (names) {
+		state = map_put(state, ATOM("names"), TRUE);
+	}
+	state = map_put(state, ATOM("body"), body);
 	state = map_put(state, ATOM("vars"), car(expr));
 	actor = ACTOR(function, state);
 	SEND(cont, map_put(NIL, expr_symbol, actor));
@@ -1296,135 +1569,76 @@ BEH_DECL(reduce_seq)
 }
 
 /**
-collect_par(op:<op>, i:<i>, expr:<expr>){acc:<acc>, n:<n>, cont:<cont>}
-	IF equal?(<op>, n)
-		<n> := <n> + <i>
-	ELIF equal?(<op>, i)
-		<acc> := map_put(<acc>, <i>, <expr>)
-		<n> := <n> - 1
+collect_par(slot:<slot>, expr:<expr>){acc:<acc>, n:<n>, cont:<cont>}
+	rest(<slot>) := <expr>
+	<n> := <n> - 1
 	IF zero?(n)
 		{expr:<acc>} => <cont>
-	ELSE
-		become(collect_par, {acc:<acc>, n:<n>, cont:<cont>})
 **/
 BEH_DECL(collect_par)
 {
 	CONS* msg = WHAT;
-	CONS* op = map_get(msg, ATOM("op"));
-	CONS* i = map_get(msg, ATOM("i"));
+	CONS* slot = map_get(msg, ATOM("slot"));
 	CONS* expr = map_get(msg, expr_symbol);
 	CONS* state = MINE;
-	CONS* acc = map_get(state, ATOM("acc"));
-	CONS* n = map_get(state, ATOM("n"));
-	CONS* cont = map_get(state, cont_symbol);
+	CONS* count = map_find(state, ATOM("n"));
+	CONS* n = cdr(count);
 
 	DBUG_ENTER("collect_par");
-	assert(numberp(i));
+	assert(consp(slot));
 	assert(numberp(n));
-	assert(consp(acc));
-	assert(actorp(cont));
-	if (op == ATOM("n")) {
-		n = NUMBER(MK_INT(n) + MK_INT(i));
-	} else if (op == ATOM("i")) {
-		DBUG_PRINT("", ("value=%s", cons_to_str(expr)));
-		acc = map_put(acc, i, expr);
-		n = NUMBER(MK_INT(n) - 1);
-	}
+	DBUG_PRINT("", ("value=%s", cons_to_str(expr)));
+	rplacd(slot, expr);				/* fill the pre-built result entry */
+	n = NUMBER(MK_INT(n) - 1);
+	rplacd(count, n);				/* counted in place, no new state */
 	DBUG_PRINT("", ("n=%d", MK_INT(n)));
 	if (n == NUMBER(0)) {
+		CONS* acc = map_get(state, ATOM("acc"));
+		CONS* cont = map_get(state, cont_symbol);
+
+		assert(actorp(cont));
 		DBUG_PRINT("", ("expr=%s", cons_to_str(acc)));
 		SEND(cont, map_put(NIL, expr_symbol, acc));
-	} else {
-		state = NIL;
-		state = map_put(state, cont_symbol, cont);
-		state = map_put(state, ATOM("n"), n);
-		state = map_put(state, ATOM("acc"), acc);
-		BECOME(THIS, state);
 	}
 	DBUG_RETURN;
 }
 
 /**
-eval_par(expr:<expr>){i:<i>, cont:<collect>}
-	{op:i, i:<i>, expr:<expr>} => <collect>
+eval_par(expr:<expr>){slot:<slot>, cont:<collect>}
+	{slot:<slot>, expr:<expr>} => <collect>
 **/
 BEH_DECL(eval_par)
 {
 	CONS* msg = WHAT;
 	CONS* expr = map_get(msg, expr_symbol);
 	CONS* state = MINE;
-	CONS* i = map_get(state, ATOM("i"));
+	CONS* slot = map_get(state, ATOM("slot"));
 	CONS* collect = map_get(state, cont_symbol);
 
 	DBUG_ENTER("eval_par");
-	assert(numberp(i));
+	assert(consp(slot));
 	assert(actorp(collect));
-	DBUG_PRINT("", ("i=%d expr=%s", MK_INT(i), cons_to_str(expr)));
+	DBUG_PRINT("", ("i=%d expr=%s", MK_INT(car(slot)), cons_to_str(expr)));
 	msg = NIL;
-	msg = map_put(msg, ATOM("op"), ATOM("i"));
-	msg = map_put(msg, ATOM("i"), i);
+	msg = map_put(msg, ATOM("slot"), slot);
 	msg = map_put(msg, expr_symbol, expr);
 	SEND(collect, msg);
 	DBUG_RETURN;
 }
 
-/**
-apply_par(i:<i>, form:<form>){cont:<collect>, env:<env>} =
-	IF empty?(<form>)
-		{op:n, i:<i>} => <collect>
-	ELSE
-		<actor> = actor(eval_par, {i:<i>, cont:<collect>})
-		{expr:first(<form>), cont:<actor>, env:<env>} => reduce
-		{i:(<i> + 1), form:rest(<form>)} => self()
-**/
-BEH_DECL(apply_par)
-{
-	CONS* msg = WHAT;
-	CONS* i = map_get(msg, ATOM("i"));
-	CONS* form = map_get(msg, form_symbol);
-	CONS* state = MINE;
-	CONS* collect = map_get(state, cont_symbol);
-	CONS* env = map_get(state, env_symbol);
-
-	DBUG_ENTER("apply_par");
-	assert(numberp(i));
-	assert(consp(form));
-	assert(actorp(collect));
-	DBUG_PRINT("", ("i=%d form=%s", MK_INT(i), cons_to_str(form)));
-	if (nilp(form)) {
-		msg = NIL;
-		msg = map_put(msg, ATOM("op"), ATOM("n"));
-		msg = map_put(msg, ATOM("i"), i);
-		SEND(collect, msg);		
-	} else {
-		CONS* actor;
-		
-		state = NIL;
-		state = map_put(state, cont_symbol, collect);
-		state = map_put(state, ATOM("i"), i);
-		actor = ACTOR(eval_par, state);
-		msg = NIL;
-		msg = map_put(msg, env_symbol, env);
-		msg = map_put(msg, cont_symbol, actor);
-		msg = map_put(msg, expr_symbol, car(form));
-		SEND(a_reduce, msg);
-		msg = NIL;
-		msg = map_put(msg, form_symbol, cdr(form));
-		msg = map_put(msg, ATOM("i"), NUMBER(MK_INT(i) + 1));
-		SEND(SELF, msg);		
-	}
-	DBUG_RETURN;
-}
-
 /**
 reduce_par(expr:<expr>, cont:<cont>, env:<env>){} =
 	IF list?(<expr>)
 		IF empty?(<expr>)
 			{expr:()} => <cont>
+		ELIF improper?(<expr>)
+			{expr:_} => <cont>
 		ELSE
-			<collect> := actor(collect_par, {acc:(), n:0, cont:<cont>})
-			<apply> := actor(apply_par, {cont:<collect>, env:<env>})
-			{i:0, form:<expr>} => <apply>
+			<acc> := {0:_, 1:_, ..., (<n> - 1):_}
+			<collect> := actor(collect_par, {acc:<acc>, n:<n>, cont:<cont>})
+			FOR EACH <i>, <form> IN <expr>
+				<actor> = actor(eval_par, {slot:entry(<acc>, <i>), cont:<collect>})
+				{expr:<form>, cont:<actor>, env:<env>} => reduce
 	ELSE
 		{expr:_} => <cont>
 **/
@@ -1442,23 +1656,41 @@ BEH_DECL(reduce_par)
 		msg = map_put(msg, expr_symbol, expr);
 		SEND(cont, msg);
 	} else {
+		CONS* q = cons(NIL, NIL);
+		CONS* acc;
 		CONS* collect;
-		CONS* apply;
+		CONS* form;
+		int n = 0;
 		
 		DBUG_PRINT("", ("form=%s", cons_to_str(expr)));
+		for (form = expr; consp(form) && !nilp(form); form = cdr(form)) {
+			CQ_PUT(q, cons(cons(NUMBER(n), NIL), NIL));	/* result slot <n> */
+			++n;
+		}
+		if (!nilp(form)) {
+			DBUG_PRINT("", ("improper list"));
+			SEND(cont, map_put(NIL, expr_symbol, undefined_symbol));
+			DBUG_RETURN;
+		}
+		acc = CQ_PEEK(q);
 		state = NIL;
 		state = map_put(state, cont_symbol, cont);
-		state = map_put(state, ATOM("n"), NUMBER(0));
-		state = map_put(state, ATOM("acc"), NIL);
+		state = map_put(state, ATOM("n"), NUMBER(n));
+		state = map_put(state, ATOM("acc"), acc);
 		collect = ACTOR(collect_par, state);
-		state = NIL;
-		state = map_put(state, env_symbol, env);
-		state = map_put(state, cont_symbol, collect);
-		apply = ACTOR(apply_par, state);
-		msg = NIL;
-		msg = map_put(msg, ATOM("i"), NUMBER(0));
-		msg = map_put(msg, form_symbol, expr);
-		SEND(apply, msg);
+		for (form = expr; consp(acc) && !nilp(acc); form = cdr(form), acc = cdr(acc)) {
+			CONS* actor;
+
+			state = NIL;
+			state = map_put(state, cont_symbol, collect);
+			state = map_put(state, ATOM("slot"), car(acc));
+			actor = ACTOR(eval_par, state);
+			msg = NIL;
+			msg = map_put(msg, env_symbol, env);
+			msg = map_put(msg, cont_symbol, actor);
+			msg = map_put(msg, expr_symbol, car(form));
+			SEND(a_reduce, msg);
+		}
 	}
 	DBUG_RETURN;
 }
@@ -1497,6 +1729,7 @@ static CONFIG*
 init_reduce()
 {
 	CONFIG* cfg;
+	CONS* p;
 	
 	if (reduce_cfg != NULL) {
 		return reduce_cfg;
@@ -1526,6 +1759,12 @@ init_reduce()
 	an_error = CFG_ACTOR(cfg, error_msg, NIL);
 	a_print = CFG_ACTOR(cfg, print_msg, NIL);
 	a_sink = CFG_ACTOR(cfg, sink_beh, NIL);
+	a_lexref = CFG_ACTOR(cfg, sink_beh, NIL);
+	cfg_add_gc_root(cfg, a_lexref);
+	a_frame = CFG_ACTOR(cfg, sink_beh, NIL);
+	cfg_add_gc_root(cfg, a_frame);
+	a_compiled = CFG_ACTOR(cfg, sink_beh, NIL);
+	cfg_add_gc_root(cfg, a_compiled);
 
 	DBUG_PRINT("", ("initializing environment"));
 	eval_env = map_put(eval_env, ATOM("System_Info"), system_info());
@@ -1596,25 +1835,28 @@ init_reduce()
 															/*** IMPLEMENTATION OF extend_env() DEPENDS ON IT ***/
 
 	cfg_add_gc_root(cfg, eval_env);
+	global_index = new_htab(64);
+	for (p = eval_env; !nilp(p); p = cdr(p)) {
+		if (nilp(htab_get(global_index, car(car(p)), NULL, NIL))) {
+			htab_put(global_index, car(car(p)), NULL, car(p));
+		}
+	}
 	return cfg;
 }
 
-BOOL
-reduce_line(CONFIG* cfg, char* line, CONS* cont)
+static BOOL
+reduce_form(CONFIG* cfg, CONS* expr, CONS* cont)
+/* reduce <expr> in the global environment, sending the result to <cont> */
 {
-	CONS* expr;
 	CONS* msg;
 	CONS* state;
 	int n;
 
-	DBUG_ENTER("reduce_line");
+	DBUG_ENTER("reduce_form");
 	assert(actorp(cont));
 	init_reduce();
-	DBUG_PRINT("", ("line=%s", line));
-	expr = str_to_cons(line);
-	if (expr == NULL) {
-		fprintf(stderr, "Syntax Error: %s\n", line);
-		DBUG_RETURN FALSE;
+	if (hash_cons_source) {
+		expr = hcons_copy(expr);	/* share identical sub-expressions */
 	}
 	state = NIL;
 	state = map_put(state, cont_symbol, cont);
@@ -1634,22 +1876,42 @@ reduce_line(CONFIG* cfg, char* line, CONS* cont)
 	DBUG_RETURN TRUE;
 }
 
+BOOL
+reduce_line(CONFIG* cfg, char* line, CONS* cont)
+{
+	CONS* expr;
+
+	DBUG_ENTER("reduce_line");
+	DBUG_PRINT("", ("line=%s", line));
+	expr = str_to_cons(line);
+	if (expr == NULL) {
+		fprintf(stderr, "Syntax Error: %s\n", line);
+		DBUG_RETURN FALSE;
+	}
+	DBUG_RETURN reduce_form(cfg, expr, cont);
+}
+
 static void
 read_reduce_print(FILE* in, CONS* out)
 {
-	char buf[1024];
+	READER* rd = new_reader(in);
 	CONFIG* cfg;
+	CONS* expr;
 	
 	DBUG_ENTER("read_reduce_print");
 	cfg = init_reduce();
 	if ((out == NULL) || !actorp(out)) {
 		out = a_sink;
 	}
-	while (fgets(buf, sizeof(buf), in)) {
-		if (!reduce_line(cfg, buf, out)) {
+	while ((expr = read_cons(rd)) != NULL) {
+		if (!reduce_form(cfg, expr, out)) {
 			break;
 		}
 	}
+	if (rd->failed) {
+		fprintf(stderr, "Syntax Error: line %d\n", rd->line);
+	}
+	rd = free_reader(rd);
 	DBUG_RETURN;
 }
 
@@ -1669,9 +1931,26 @@ assert_reduce(char* expr, char* value)
 	}
 }
 
+static void
+assert_reduce_form(CONS* expr, CONS* expect)
+/* like assert_reduce(), for forms (and values) the reader can not express */
+{
+	CONS* state;
+	CONS* cont;
+
+	state = map_put(NIL, ATOM("expect"), expect);
+	cont = CFG_ACTOR(reduce_cfg, assert_msg, state);
+	if (!reduce_form(reduce_cfg, expr, cont)) {
+		fprintf(stderr, "assert_reduce_form: FAILED! %s\n", cons_to_str(expr));
+		abort();
+	}
+}
+
 void
 test_reduce()
 {
+	CONS* vars;
+
 	DBUG_ENTER("test_reduce");
 	init_reduce();
 	TRACE(printf("--test_reduce--\n"));
@@ -1763,11 +2042,20 @@ test_reduce()
 	assert_reduce("((function (x) (if x FALSE TRUE)) FALSE)", "TRUE");	
 	assert_reduce("((function (x) (list (literal Hello) x)) (literal World))", "(Hello World)");
 	assert_reduce("(((function (x) (function (y) (sum x y))) 3) 4)", "7");
+	assert_reduce("(((function (x y) (function (y) (list x y))) 1 2) 3)", "(1 3)");
+	assert_reduce("((function args (rest args)) 1 2)", "(2)");
 	reduce_line(reduce_cfg, "(define fact (function (n) (if (zero? n) 1 (product n (fact (sum n -1))))))", a_sink);
 	assert_reduce("(fact 3)", "6");
 
 	assert_reduce("(reduce 0)", "0");
 	assert_reduce("(reduce (literal (equal? 0 0)))", "TRUE");
+	assert_reduce("((function (x) (reduce (literal x))) 5)", "5");
+	assert_reduce("((function (x y) (reduce y)) 5 (literal (sum x 1)))", "6");
+	reduce_line(reduce_cfg, "(define fn (template (args body) (function args body)))", a_sink);
+	assert_reduce("((function (k) ((fn (y) (sum k y)) 1)) 2)", "3");
+	vars = str_to_cons("(x y)");
+	assert(!lex_named(lex_compile(str_to_cons("(sum x y)"), cons(vars, NIL)), vars));
+	assert(lex_named(lex_compile(str_to_cons("(list (literal x) y)"), cons(vars, NIL)), vars));
 
 	reduce_line(reduce_cfg, "(define not (function (x) (if x FALSE TRUE)))", a_sink);
 	assert_reduce("(not TRUE)", "FALSE");
@@ -1781,6 +2069,29 @@ test_reduce()
 	assert_reduce("(symbol? (literal x))", "TRUE");
 	reduce_line(reduce_cfg, "(define swap2 (function (x y) (prepend y (prepend x NIL))))", a_sink);
 	assert_reduce("(swap2 0 1 2)", "(1 0)");
+
+	/*
+	 * a define inside an actor shadows the enclosing function's parameter
+	 */
+	{
+		CONS* expect;
+
+		expect = CFG_ACTOR(reduce_cfg, assert_msg, map_put(NIL, ATOM("expect"), NUMBER(2)));
+		extend_env(eval_env, ATOM("@expect"), expect);
+		reduce_line(reduce_cfg,
+			"(define probe ((function (x) (actor (function (k m) (seq (define x m) (send k x))))) 1))",
+			a_sink);
+		reduce_line(reduce_cfg, "(send probe (list @expect 2))", a_sink);
+		assert(_THIS(expect) == sink_beh);	/* assert_msg was satisfied */
+	}
+
+	assert_reduce("(par)", "()");
+	assert_reduce_form(str_to_cons("(par (sum 1 2) (product 2 3) (literal x))"),
+		cons(cons(NUMBER(0), NUMBER(3)),	/* ((0 . 3) (1 . 6) (2 . x)) */
+			cons(cons(NUMBER(1), NUMBER(6)),
+				cons(cons(NUMBER(2), ATOM("x")), NIL))));
+	assert_reduce_form(cons(ATOM("par"), cons(NUMBER(1), NUMBER(2))),	/* (par 1 . 2) */
+		undefined_symbol);
 	
 #if 0
 	assert_reduce("(?)", "_");	/* this case produces error messages, but should pass */
@@ -1811,7 +2122,7 @@ void
 usage(void)
 {
 	fprintf(stderr, "\
-usage: %s [-ti] [-# dbug] file...\n",
+usage: %s [-tiH] [-# dbug] file...\n",
 		_Program);
 	exit(EXIT_FAILURE);
 }
@@ -1831,10 +2142,11 @@ main(int argc, char** argv)
 
 	DBUG_ENTER("main");
 	DBUG_PROCESS(argv[0]);
-	while ((c = getopt(argc, argv, "ti#:V")) != EOF) {
+	while ((c = getopt(argc, argv, "tiH#:V")) != EOF) {
 		switch(c) {
 		case 't':	test_mode = TRUE;		break;
 		case 'i':	interactive = TRUE;		break;
+		case 'H':	hash_cons_source = TRUE;	break;
 		case '#':	DBUG_PUSH(optarg);		break;
 		case 'V':	banner();				exit(EXIT_SUCCESS);
 		case '?':							usage();
@@ -1851,6 +2163,7 @@ main(int argc, char** argv)
 		cfg = init_reduce();
 		show_result = CFG_ACTOR(cfg, print_msg,
 			map_put(NIL, ATOM("message"), ATOM("= ")));
+		cfg_add_gc_root(cfg, show_result);
 		while (optind < argc) {
 			FILE* f;
 			char* filename = argv[optind++];
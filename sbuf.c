@@ -17,6 +17,8 @@ new_sbuf(size_t size)
 	sbuf->limit = size - 1;
 	sbuf->offset = 0;
 	sbuf->buf = (char*)malloc(size);
+	assert(sbuf->buf != NULL);
+	sbuf->buf[0] = '\0';
 	return sbuf;
 }
 
@@ -35,16 +37,41 @@ free_sbuf(SBUF* sbuf)
 	return NULL;
 }
 
+char*
+sbuf_release(SBUF* sbuf)	/* WARNING! caller must free the returned string */
+{
+	char* s = sbuf->buf;
+
+	free(sbuf);
+	return s;
+}
+
+static void
+sbuf_grow(SBUF* sbuf, size_t n)
+/* ensure room for <n> more characters (plus terminator) */
+{
+	size_t size = sbuf->limit + 1;
+
+	if ((sbuf->offset + n) < sbuf->limit) {
+		return;
+	}
+	while ((sbuf->offset + n) >= (size - 1)) {
+		size <<= 1;
+	}
+	sbuf->buf = (char*)realloc(sbuf->buf, size);
+	assert(sbuf->buf != NULL);
+	sbuf->limit = size - 1;
+}
+
 void
 sbuf_emit(char c, void* ctx)
 {
 	SBUF* sbuf = (SBUF*)ctx;
 	
-	if (sbuf->offset < sbuf->limit) {
-		sbuf->buf[sbuf->offset] = c;
-		++sbuf->offset;
-		sbuf->buf[sbuf->offset] = '\0';
-	}
+	sbuf_grow(sbuf, 1);
+	sbuf->buf[sbuf->offset] = c;
+	++sbuf->offset;
+	sbuf->buf[sbuf->offset] = '\0';
 }
 
 void
@@ -53,11 +80,10 @@ sbuf_emits(char* s, size_t n, void* ctx)
 	char c;
 	SBUF* sbuf = (SBUF*)ctx;
 	
-	if ((sbuf->offset + n) < sbuf->limit) {
-		while ((c = *s++) && (n-- > 0)) {
-			sbuf->buf[sbuf->offset] = c;
-			++sbuf->offset;
-		}
-		sbuf->buf[sbuf->offset] = '\0';
+	sbuf_grow(sbuf, n);
+	while ((n-- > 0) && (c = *s++)) {
+		sbuf->buf[sbuf->offset] = c;
+		++sbuf->offset;
 	}
+	sbuf->buf[sbuf->offset] = '\0';
 }
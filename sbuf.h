@@ -19,7 +19,8 @@ struct string_buffer {
 SBUF*	new_sbuf(size_t size);
 void	clear_sbuf(SBUF* sbuf);
 SBUF*	free_sbuf(SBUF* sbuf);
-void	sbuf_emit(char c, void* ctx);
+char*	sbuf_release(SBUF* sbuf);	/* free <sbuf>, but return its string */
+void	sbuf_emit(char c, void* ctx);	/* append <c>, growing as needed */
 void	sbuf_emits(char* s, size_t n, void* ctx);
 
 #endif /* SBUF_H */
@@ -40,6 +40,8 @@ DBUG_UNIT("schemer");
 #define	is_actor(p)		actorp(p)
 #define	is_const(p)		(is_null(p)||is_number(p)||is_boolean(p)||is_undefined(p))
 
+static BOOL hash_cons_source = FALSE;	/* share identical source sub-trees */
+
 static CONS* eval__actor = NULL;
 static CONS* eval_list__actor = NULL;
 static CONS* eval_par__actor = NULL;
@@ -352,6 +354,119 @@ BEH_DECL(frame_beh)
 	DBUG_RETURN;
 }
 
+/*
+ * The global environment is a single table_frame_beh actor.  Its
+ * bindings are (name . value) cells listed in its state, and indexed
+ * by frame_index, so a variable reference costs one message however
+ * many names the frame holds.  Only the permanent global frame uses
+ * a table, so the index never holds cells of a collected frame.
+ */
+static HTAB* frame_index = NULL;	/* (frame, name) -> (name . value) */
+
+static CONS*
+table_frame_add(CONS* frame, CONS* name, CONS* value)
+{
+	CONS* bindings = pr_tail(_MINE(frame));
+	CONS* binding = mk_pair(name, value);
+
+	rplacd(_MINE(frame), mk_list(binding, bindings));	/* in place, to keep the index valid */
+	htab_put(frame_index, frame, name, binding);
+	return binding;
+}
+
+/**
+table_frame_beh:
+	BEHAVIOR $parent:$bindings
+	$to:((define $n $v):$env) -> [
+		IF bound?($n) [
+			SET $bindings($n) $v
+			SEND $to "redefined"
+		] ELSE [
+			BECOME THIS $parent:(($n:$v):$bindings)
+			SEND $to "ok"
+		]
+	]
+	$to:((set! $n $v):$env) -> [
+		IF bound?($n) [
+			SET $bindings($n) $v
+			SEND $to "ok"
+		] ELIF null?($parent) [
+			FAIL "unknown"
+		] ELSE [
+			SEND $parent WHAT
+		]
+	]
+	$to:((get $n):$env) -> [
+		IF bound?($n) [
+			SEND $to $bindings($n)
+		] ELIF null?($parent) [
+			FAIL "unknown"
+		] ELSE [
+			SEND $parent WHAT
+		]
+	]
+	DONE
+**/
+BEH_DECL(table_frame_beh)
+{
+	CONS* parent = pr_head(MINE);
+	CONS* p;
+	CONS* msg;
+
+	DBUG_ENTER("table_frame_beh");
+	if (is_pair(WHAT) && is_pair(p = pr_tail(WHAT))) {
+		CONS* to = pr_head(WHAT);
+		CONS* expr = pr_head(p);
+		CONS* env = pr_tail(p);
+		CONS* verb;
+		CONS* n;
+		CONS* binding;
+
+		DBUG_PRINT("", ("expr = %s", cons_to_str(expr)));
+		p = expr;
+		verb = lst_first(p);
+		p = lst_rest(p);
+		n = lst_first(p);
+		p = lst_rest(p);
+		binding = htab_get(frame_index, SELF, n, NIL);
+		if (verb == ATOM("define")) {
+			CONS* v = lst_first(p);
+
+			DBUG_PRINT("", ("n = %s", cons_to_str(n)));
+			DBUG_PRINT("", ("v = %s", cons_to_str(v)));
+			if (is_empty(binding)) {
+				table_frame_add(SELF, n, v);
+				SEND(to, ATOM("ok"));
+			} else {
+				rplacd(binding, v);
+				SEND(to, ATOM("redefined"));
+			}
+		} else if (!is_empty(binding)) {
+			if (verb == ATOM("get")) {
+				DBUG_PRINT("", ("value = %s", cons_to_str(pr_tail(binding))));
+				SEND(to, pr_tail(binding));
+			} else if (verb == ATOM("set!")) {
+				rplacd(binding, lst_first(p));
+				SEND(to, ATOM("ok"));
+			} else {
+				DBUG_PRINT("", ("Unknown! %s", cons_to_str(expr)));
+				abort();
+			}
+		} else if (is_actor(parent)) {
+			SEND(parent, WHAT);
+		} else {
+			DBUG_PRINT("", ("unknown"));
+			msg = mk_list(n, mk_empty());
+			msg = mk_list(ATOM("unknown-symbol"), msg);
+			FAIL(env, msg);
+		}
+	} else {
+		DBUG_PRINT("", ("Ignored! %s", cons_to_str(WHAT)));
+		abort();
+	}
+	DBUG_RETURN;
+}
+
 /**
 apply_lambda_beh:
 	BEHAVIOR $to:($lambda:$env)
@@ -642,6 +757,73 @@ BEH_DECL(eval_form_beh)
 // (let ((<var_1> _) ... (<var_n> _)) (set! <var_1> <exp_1>) ... (set! <var_n> <exp_n>) <body>)
 **/
 
+/*
+ * A combination whose operator names a primitive (a fn_eval_beh actor)
+ * and whose operands are all constants or variables is evaluated in one
+ * step.  The names are resolved by searching the environment's actors
+ * directly, so the lookup always sees the current binding and a local
+ * or redefined name is never mistaken for the primitive.  The argument
+ * list is then sent straight to the primitive's apply behavior.  A
+ * variable reference is answered the same way.  Anything that cannot
+ * be resolved directly, including an unbound name, takes the usual
+ * message-based path.
+ */
+BEH_DECL(fn_eval_beh);		/* FORWARD */
+
+static CONS*
+env_value(CONS* env, CONS* name)
+/* current value of <name> in <env>, or NULL if not found by direct search */
+{
+	CONS* state;
+	CONS* binding;
+	BEH beh;
+
+	while (is_actor(env)) {
+		beh = _THIS(env);
+		state = _MINE(env);
+		if (beh == binding_beh) {
+			if (pr_head(pr_tail(state)) == name) {
+				return pr_tail(pr_tail(state));
+			}
+			env = pr_head(state);
+		} else if (beh == frame_beh) {
+			env = state;
+		} else if (beh == table_frame_beh) {
+			binding = htab_get(frame_index, env, name, NIL);
+			if (!is_empty(binding)) {
+				return pr_tail(binding);
+			}
+			env = pr_head(state);
+		} else {
+			break;		/* not an environment we can search */
+		}
+	}
+	return NULL;
+}
+
+static CONS*
+simple_args(CONS* expr, CONS* env)
+/* values of <expr> if each is a constant or a bound variable, else NULL */
+{
+	CONS* q = cons(NIL, NIL);
+	CONS* x;
+
+	while (is_pair(expr)) {
+		x = pr_head(expr);
+		if (is_symbol(x)) {
+			x = env_value(env, x);
+		} else if (!is_const(x) && !is_actor(x)) {
+			x = NULL;
+		}
+		if (x == NULL) {
+			return NULL;
+		}
+		CQ_PUT(q, mk_list(x, mk_empty()));
+		expr = pr_tail(expr);
+	}
+	return (is_empty(expr) ? CQ_PEEK(q) : NULL);
+}
+
 /**
 eval_beh:
 	BEHAVIOR
@@ -650,8 +832,14 @@ eval_beh:
 			SEND $to $expr
 		] ELIF actor?($expr) [
 			SEND $to $expr		// treat actor as a literal value
+		] ELIF bound?($expr, $env) [
+			SEND $to lookup($expr, $env)
 		] ELIF symbol?($expr) [
 			SEND $env $to:((get $expr):$env)
+		] ELIF primitive?(lookup(pr_head($expr), $env))
+			AND simple?(pr_tail($expr), $env) [
+			a: ACTOR $apply_f_beh $to:$env	// from the fn_eval_beh
+			SEND $a values(pr_tail($expr), $env)
 		] ELIF pair?($expr) [
 			a: ACTOR $apply_beh $to:(pr_tail($expr):$env)
 			SEND SELF $a:(pr_head($expr):$env)
@@ -674,6 +862,8 @@ BEH_DECL(eval_beh)
 		CONS* to = pr_head(WHAT);
 		CONS* expr = pr_head(p);
 		CONS* env = pr_tail(p);
+		CONS* f;
+		CONS* args = NULL;
 
 		DBUG_PRINT("", ("expr = %s", cons_to_str(expr)));
 		if (is_const(expr)) {
@@ -682,6 +872,9 @@ BEH_DECL(eval_beh)
 		} else if (is_actor(expr)) {
 			DBUG_PRINT("", ("actor"));
 			SEND(to, expr);
+		} else if (is_symbol(expr) && ((f = env_value(env, expr)) != NULL)) {
+			DBUG_PRINT("", ("variable"));
+			SEND(to, f);
 		} else if (is_symbol(expr)) {
 			DBUG_PRINT("", ("symbol"));
 			msg = mk_empty();
@@ -690,6 +883,14 @@ BEH_DECL(eval_beh)
 			msg = mk_pair(msg, env);
 			msg = mk_pair(to, msg);
 			SEND(env, msg);
+		} else if (is_pair(expr)
+		&& is_symbol(f = pr_head(expr))
+		&& ((f = env_value(env, f)) != NULL)
+		&& is_actor(f) && (_THIS(f) == fn_eval_beh)
+		&& ((args = simple_args(pr_tail(expr), env)) != NULL)) {
+			DBUG_PRINT("", ("primitive"));
+			a = ACTOR(MK_BEH(_MINE(f)), mk_pair(to, env));
+			SEND(a, args);
 		} else if (is_pair(expr)) {
 			DBUG_PRINT("", ("combination"));
 			state = mk_pair(pr_tail(expr), env);
@@ -1107,56 +1308,65 @@ BEH_DECL(eval_list_beh)
 	DBUG_RETURN;
 }
 
-/**
-join_value_beh:
-	BEHAVIOR $to:$list
-	$to:$value -> SEND $to mk_list($value, $list)
-	DONE
-**/
-BEH_DECL(join_value_beh)
+/*
+ * A parallel evaluation of N expressions joins at a single actor.  The
+ * result list is built up front with one open slot per expression (an
+ * open slot refers to itself), and each value is labeled with its slot.
+ * The list is delivered once, when the last slot fills.  A value that
+ * arrives after that (a re-entered continuation) is delivered in a copy.
+ */
+static CONS*
+par_slots(CONS* list, CONS* slot, CONS* value)
+/* copy of <list> with <value> in place of <slot>'s element */
 {
-	CONS* to;
-	CONS* value;
-	CONS* list;
+	CONS* q = cons(NIL, NIL);
 
-	DBUG_ENTER("join_value_beh");
-	to = pr_head(MINE);
-	list = pr_tail(MINE);
-	if (is_pair(WHAT) && (pr_head(WHAT) == to)) {
-		DBUG_PRINT("", ("list = %s", cons_to_str(list)));
-		value = pr_tail(WHAT);
-		DBUG_PRINT("", ("value = %s", cons_to_str(value)));
-		SEND(to, mk_list(value, list));
-	} else {
-		DBUG_PRINT("", ("Ignored! %s", cons_to_str(WHAT)));
-		abort();
+	while (is_pair(list)) {
+		CQ_PUT(q, mk_list(((list == slot) ? value : pr_head(list)), mk_empty()));
+		list = pr_tail(list);
 	}
-	DBUG_RETURN;
+	return CQ_PEEK(q);
 }
 
 /**
-join_par_beh:
-	BEHAVIOR $to
-	$to:$value -> BECOME $join_list_beh $to:$value
-	$list -> BECOME $join_value_beh $to:$list
+join_slots_beh:
+	BEHAVIOR $to:($n:$slots)
+	$slot:$value -> [
+		IF $n = 0 [
+			SEND $to copy($slots) with $value in $slot
+		] ELSE [
+			n': IF open?($slot) [ $n - 1 ] ELSE [ $n ]
+			fill $slot with $value
+			IF $n' = 0 [
+				SEND $to $slots
+			]
+			BECOME THIS $to:($n':$slots)
+		]
+	]
 	DONE
 **/
-BEH_DECL(join_par_beh)
+BEH_DECL(join_slots_beh)
 {
-	CONS* to;
-	CONS* value;
-	CONS* list;
-
-	DBUG_ENTER("join_par_beh");
-	to = MINE;
-	if (is_pair(WHAT) && (pr_head(WHAT) == to)) {
-		value = pr_tail(WHAT);
-		DBUG_PRINT("", ("value = %s", cons_to_str(value)));
-		BECOME(join_list_beh, mk_pair(to, value));
-	} else if (is_list(WHAT)) {
-		list = WHAT;
-		DBUG_PRINT("", ("list = %s", cons_to_str(list)));
-		BECOME(join_value_beh, mk_pair(to, list));
+	CONS* to = pr_head(MINE);
+	int n = MK_INT(pr_head(pr_tail(MINE)));
+	CONS* slots = pr_tail(pr_tail(MINE));
+	CONS* slot;
+
+	DBUG_ENTER("join_slots_beh");
+	if (is_pair(WHAT) && is_pair(slot = pr_head(WHAT))) {
+		DBUG_PRINT("", ("value = %s", cons_to_str(pr_tail(WHAT))));
+		if (n == 0) {
+			SEND(to, par_slots(slots, slot, pr_tail(WHAT)));
+		} else {
+			if (pr_head(slot) == slot) {
+				--n;		/* first value for this slot */
+			}
+			rplaca(slot, pr_tail(WHAT));
+			if (n == 0) {
+				SEND(to, slots);
+			}
+			BECOME(THIS, mk_pair(to, mk_pair(NUMBER(n), slots)));
+		}
 	} else {
 		DBUG_PRINT("", ("Ignored! %s", cons_to_str(WHAT)));
 		abort();
@@ -1171,11 +1381,12 @@ eval_par_beh:
 		IF empty?($expr) [
 			SEND $to mk_empty()
 		] ELSE [
-			k: ACTOR $join_par_beh $to
-			SEND SELF $k:(pr_tail($expr):$env)
-			e: ACTOR $eval_beh NIL
-			a: ACTOR $label_beh $k:$to
-			SEND $e $a:(pr_head($expr):$env)
+			slots: one open slot per element of $expr
+			k: ACTOR $join_slots_beh $to:(length($expr):$slots)
+			FOR EACH $x IN $expr, $s IN $slots [
+				a: ACTOR $label_beh $k:$s
+				SEND eval__actor $a:($x:$env)
+			]
 		]
 	]
 	DONE
@@ -1192,22 +1403,33 @@ BEH_DECL(eval_par_beh)
 		CONS* to = pr_head(WHAT);
 		CONS* expr = pr_head(p);
 		CONS* env = pr_tail(p);
+		CONS* q = cons(NIL, NIL);
+		CONS* slots;
+		CONS* s;
+		int n = 0;
 
 		DBUG_PRINT("", ("expr = %s", cons_to_str(expr)));
+		for (p = expr; is_pair(p); p = pr_tail(p)) {
+			s = mk_list(NIL, mk_empty());
+			rplaca(s, s);		/* open slot */
+			CQ_PUT(q, s);
+			++n;
+		}
 		if (is_empty(expr)) {
 			SEND(to, mk_empty());
-		} else if (is_pair(expr)) {
-			k = ACTOR(join_par_beh, to);
-			msg = mk_pair(pr_tail(expr), env);
-			msg = mk_pair(k, msg);
-			SEND(SELF, msg);
-			a = ACTOR(label_beh, mk_pair(k, to));
-			msg = mk_pair(pr_head(expr), env);
-			msg = mk_pair(a, msg);
-			SEND(eval__actor, msg);
+		} else if (is_empty(p)) {
+			slots = CQ_PEEK(q);
+			k = ACTOR(join_slots_beh, mk_pair(to, mk_pair(NUMBER(n), slots)));
+			for (s = slots; is_pair(s); s = pr_tail(s)) {
+				a = ACTOR(label_beh, mk_pair(k, s));
+				msg = mk_pair(pr_head(expr), env);
+				msg = mk_pair(a, msg);
+				SEND(eval__actor, msg);
+				expr = pr_tail(expr);
+			}
 		} else {
 			DBUG_PRINT("", ("error"));
-			msg = mk_list(ATOM("par"), expr);
+			msg = mk_list(ATOM("par"), p);
 			FAIL(env, msg);
 		}
 	} else {
@@ -2429,6 +2651,10 @@ init_add_binding(CONFIG* cfg, CONS* env, CONS* name, CONS* value)
 {
 	assert(actorp(env));
 	assert(atomp(name));
+	if (_THIS(env) == table_frame_beh) {
+		table_frame_add(env, name, value);
+		return env;
+	}
 	return CFG_ACTOR(cfg, binding_beh, mk_pair(env, mk_pair(name, value)));
 }
 
@@ -2444,7 +2670,8 @@ init_schemer(CONFIG* cfg)
 		eval_list__actor = CFG_ACTOR(cfg, eval_list_beh, NIL);
 		eval_par__actor = CFG_ACTOR(cfg, eval_par_beh, NIL);
 		eval_seq__actor = CFG_ACTOR(cfg, eval_seq_beh, NIL);
-		env = CFG_ACTOR(cfg, frame_beh, NIL);
+		frame_index = new_htab(64);
+		env = CFG_ACTOR(cfg, table_frame_beh, mk_pair(NIL, NIL));
 
 		a = CFG_ACTOR(cfg, eval_fail_beh, NIL);
 		env = init_add_binding(cfg, env, ATOM("fail!"), a);	/* WARNING: non-standard exception signal */
@@ -2513,36 +2740,42 @@ init_schemer(CONFIG* cfg)
 		env = init_add_binding(cfg, env, ATOM("call/cc"), a);
 
 		cfg_add_gc_root(cfg, env);
+		cfg_add_gc_root(cfg, mk_pair(eval__actor, mk_pair(eval_list__actor,
+			mk_pair(eval_par__actor, eval_seq__actor))));	/* protect from gc */
 		initial__environment = env;
 	}
 	DBUG_RETURN initial__environment;
 }
 
-BOOL
-reduce_line(CONFIG* cfg, char* line, CONS* cont)
+static CONS*
+line_env(CONFIG* cfg, CONS* env, CONS* cont)
+/* extend <env> with an exception handler reporting to <cont> */
+{
+	CONS* a = CFG_ACTOR(cfg, fail_beh, cont);
+
+	return CFG_ACTOR(cfg, binding_beh, mk_pair(env, mk_pair(UNDEFINED, a)));
+}
+
+static BOOL
+reduce_form(CONFIG* cfg, CONS* expr, CONS* cont)
+/* evaluate <expr> in the global environment, sending the result to <cont> */
 {
-	CONS* expr;
 	CONS* env;
 	CONS* msg;
-	CONS* a;
 	int n;
 
-	DBUG_ENTER("reduce_line");
+	DBUG_ENTER("reduce_form");
 	assert(actorp(cont));
 	cont = CFG_ACTOR(cfg, one_shot_beh, cont);
-	DBUG_PRINT("", ("line=%s", line));
-	expr = str_to_cons(line);
-	if (expr == NULL) {
-		fprintf(stderr, "Syntax Error: %s\n", line);
-		DBUG_RETURN FALSE;
+	if (hash_cons_source) {
+		expr = hcons_copy(expr);	/* share identical sub-expressions */
 	}
 	env = init_schemer(cfg);
 #if 1
 #if 0
 	env = CFG_ACTOR(cfg, frame_beh, env);	/* create a new frame to protect the global environment */
 #endif
-	a = CFG_ACTOR(cfg, fail_beh, cont);
-	env = init_add_binding(cfg, env, UNDEFINED, a);		/* install exception handler */
+	env = line_env(cfg, env, cont);		/* install exception handler */
 #endif
 	msg = mk_pair(cont, mk_pair(expr, env));
 	CFG_SEND(cfg, eval__actor, msg);
@@ -2568,17 +2801,99 @@ reduce_line(CONFIG* cfg, char* line, CONS* cont)
 	DBUG_RETURN TRUE;
 }
 
+BOOL
+reduce_line(CONFIG* cfg, char* line, CONS* cont)
+{
+	CONS* expr;
+
+	DBUG_ENTER("reduce_line");
+	DBUG_PRINT("", ("line=%s", line));
+	expr = str_to_cons(line);
+	if (expr == NULL) {
+		fprintf(stderr, "Syntax Error: %s\n", line);
+		DBUG_RETURN FALSE;
+	}
+	DBUG_RETURN reduce_form(cfg, expr, cont);
+}
+
 static void
 read_reduce_print(CONFIG* cfg, FILE* in, CONS* out)
 {
-	char buf[1024];
+	READER* rd = new_reader(in);
+	CONS* expr;
 	
 	DBUG_ENTER("read_reduce_print");
-	while (fgets(buf, sizeof(buf), in)) {
-		if (!reduce_line(cfg, buf, out)) {
+	while ((expr = read_cons(rd)) != NULL) {
+		if (!reduce_form(cfg, expr, out)) {
 			break;
 		}
 	}
+	if (rd->failed) {
+		fprintf(stderr, "Syntax Error: line %d\n", rd->line);
+	}
+	rd = free_reader(rd);
+	DBUG_RETURN;
+}
+
+/*
+ * A session (-s) keeps one environment across all of its input lines,
+ * and evaluates them one at a time, so each line sees every side effect
+ * of the lines before it.  There is no forced collection per line; an
+ * incremental collection is started in the background every
+ * SESSION_GC_LINES lines instead.
+ */
+#define	SESSION_GC_LINES	32	/* lines between background collections */
+
+static BOOL
+session_drain(CONFIG* cfg)
+/* dispatch until no messages or timed events remain, FALSE if aborted */
+{
+	int n = 0;
+
+	while (n == 0) {
+		n = run_configuration(cfg, 100000);
+		if (cfg->t_count > 0) {
+			DBUG_PRINT("", ("waiting for timed event..."));
+			sleep(1);
+			n = 0;		/* reset */
+		}
+	}
+	return (n > 0) ? TRUE : FALSE;
+}
+
+static void
+read_session(CONFIG* cfg, FILE* in, CONS* out)
+{
+	static CONS* env = NULL;	/* session environment */
+	READER* rd = new_reader(in);
+	CONS* expr;
+	CONS* cont;
+	int lines = 0;
+
+	DBUG_ENTER("read_session");
+	if (env == NULL) {
+		env = init_schemer(cfg);
+		cfg_add_gc_root(cfg, env);		/* protect from gc */
+	}
+	while ((expr = read_cons(rd)) != NULL) {
+		if (hash_cons_source) {
+			expr = hcons_copy(expr);	/* share identical sub-expressions */
+		}
+		if (lines >= SESSION_GC_LINES) {
+			cfg_start_gc(cfg);	/* runs concurrently with the following line */
+			lines = 0;
+		}
+		cont = CFG_ACTOR(cfg, one_shot_beh, out);
+		CFG_SEND(cfg, eval__actor, mk_pair(cont, mk_pair(expr, line_env(cfg, env, cont))));
+		++lines;
+		if (!session_drain(cfg)) {
+			break;
+		}
+	}
+	if (rd->failed) {
+		fprintf(stderr, "Syntax Error: line %d\n", rd->line);
+	}
+	rd = free_reader(rd);
 	DBUG_RETURN;
 }
 
@@ -2598,6 +2913,63 @@ assert_reduce(CONFIG* cfg, char* expr, char* value)
 	}
 }
 
+static void
+assert_reduce_form(CONFIG* cfg, CONS* expr, CONS* expect)
+/* like assert_reduce(), for forms the reader can not express */
+{
+	CONS* state;
+	CONS* cont;
+
+	state = map_put(NIL, ATOM("expect"), expect);
+	cont = CFG_ACTOR(cfg, assert_msg, state);
+	if (!reduce_form(cfg, expr, cont)) {
+		fprintf(stderr, "assert_reduce_form: FAILED! %s\n", cons_to_str(expr));
+		abort();
+	}
+}
+
+/**
+expect_seq_beh:
+	BEHAVIOR $expect
+	$actual -> IF equal(pr_head($expect), $actual) [
+		BECOME THIS pr_tail($expect)
+	] ELSE [
+		// print and abort
+	]
+	DONE
+**/
+static
+BEH_DECL(expect_seq_beh)
+{
+	CONS* expect = MINE;
+
+	DBUG_ENTER("expect_seq_beh");
+	if (!is_pair(expect) || !equal(pr_head(expect), WHAT)) {
+		fprintf(stderr, "expect_seq_beh: FAILED! %s\n", cons_to_str(WHAT));
+		abort();
+	}
+	BECOME(THIS, pr_tail(expect));
+	DBUG_RETURN;
+}
+
+static void
+assert_session(CONFIG* cfg, char* lines, char* values)
+{
+	FILE* f = tmpfile();
+	CONS* out;
+
+	assert(f != NULL);
+	fputs(lines, f);
+	rewind(f);
+	out = CFG_ACTOR(cfg, expect_seq_beh, str_to_cons(values));
+	read_session(cfg, f, out);
+	fclose(f);
+	if (!nilp(_MINE(out))) {
+		fprintf(stderr, "assert_session: FAILED! %s -> %s\n", lines, values);
+		abort();
+	}
+}
+
 void
 test_schemer(CONFIG* cfg)
 {
@@ -2632,6 +3004,9 @@ test_schemer(CONFIG* cfg)
 	assert_reduce(cfg, "(define z -1)", "ok");	/* NOTE: this is unspecified */
 	assert_reduce(cfg, "z", "-1");
 	assert_reduce(cfg, "(define z 1)", "redefined");	/* NOTE: this is unspecified */
+	assert_reduce(cfg, "(set! z 2)", "ok");
+	assert_reduce(cfg, "z", "2");
+	assert_reduce(cfg, "(set! cons cons)", "ok");
 	assert_reduce(cfg, "(begin (define z 0) z)", "0");
 	assert_reduce(cfg, "(list 1 2 3)", "(1 2 3)");
 	assert_reduce(cfg, "(list z 0)", "(0 0)");
@@ -2660,6 +3035,8 @@ test_schemer(CONFIG* cfg)
 
 	assert_reduce(cfg, "((lambda (x) x) 1)", "1");
 	assert_reduce(cfg, "(((lambda (x) (lambda (y) (list '+ x y))) 3) 4)", "(+ 3 4)");
+	assert_reduce(cfg, "((lambda (+ x) (+ x 1)) - 3)", "2");	/* shadowed primitive */
+	assert_reduce(cfg, "((lambda (x) (+ x y)) 1)", "(FAILURE! unknown-symbol y)");
 
 	assert_reduce(cfg, "(eq? 0 0)", "#t");
 	assert_reduce(cfg, "(eq? 0 1)", "#f");
@@ -2755,6 +3132,18 @@ test_schemer(CONFIG* cfg)
 	
 	assert_reduce(cfg, "(+ 1 (call/cc (lambda (esc) (+ 2 (esc 3)))))", "4");
 
+	assert_reduce(cfg, "(par)", "()");
+	assert_reduce(cfg, "(par 1)", "(1)");
+	assert_reduce(cfg, "(par (+ 1 2) (* 2 3) 'x (list 4))", "(3 6 x (4))");
+	assert_reduce(cfg, "(list (par) (par 'y))", "(() (y))");
+	assert_reduce_form(cfg,		/* (par 1 . 2) */
+		mk_pair(ATOM("par"), mk_pair(NUMBER(1), NUMBER(2))),
+		mk_pair(ATOM("FAILURE!"), mk_pair(ATOM("par"), NUMBER(2))));
+
+	assert_session(cfg,
+		"(define sn 0)\n(define (bump) (set! sn (+ sn 1)))\n(bump)\nsn\n(bump)\nsn\n",
+		"(ok ok ok 1 ok 2)");
+
 #if 0
 	assert_reduce("((template (x) (literal x)) 0)", "0");
 	assert_reduce("((template (x y) (literal (y x))) TRUE FALSE)", "(FALSE TRUE)");
@@ -2801,7 +3190,7 @@ void
 usage(void)
 {
 	fprintf(stderr, "\
-usage: %s [-ti] [-# dbug] file...\n",
+usage: %s [-tiHs] [-# dbug] file...\n",
 		_Program);
 	exit(EXIT_FAILURE);
 }
@@ -2818,13 +3207,16 @@ main(int argc, char** argv)
 	int c;
 	BOOL test_mode = FALSE;			/* flag to run unit tests */
 	BOOL interactive = FALSE;		/* flag to run unit tests */
+	BOOL session = FALSE;			/* flag to keep one session across lines */
 
 	DBUG_ENTER("main");
 	DBUG_PROCESS(argv[0]);
-	while ((c = getopt(argc, argv, "ti#:V")) != EOF) {
+	while ((c = getopt(argc, argv, "tiHs#:V")) != EOF) {
 		switch(c) {
 		case 't':	test_mode = TRUE;		break;
 		case 'i':	interactive = TRUE;		break;
+		case 'H':	hash_cons_source = TRUE;	break;
+		case 's':	session = TRUE;			break;
 		case '#':	DBUG_PUSH(optarg);		break;
 		case 'V':	banner();				exit(EXIT_SUCCESS);
 		case '?':							usage();
@@ -2853,12 +3245,20 @@ main(int argc, char** argv)
 				exit(EXIT_FAILURE);
 			}
 			TRACE(printf("Loading %s...\n", filename));
-			read_reduce_print(cfg, f, show_result);
+			if (session) {
+				read_session(cfg, f, show_result);
+			} else {
+				read_reduce_print(cfg, f, show_result);
+			}
 			fclose(f);
 		}
 		if (interactive) {
 			printf("Entering INTERACTIVE mode.\n");
-			read_reduce_print(cfg, stdin, show_result);
+			if (session) {
+				read_session(cfg, stdin, show_result);
+			} else {
+				read_reduce_print(cfg, stdin, show_result);
+			}
 		}
 #endif
 		report_actor_usage(cfg);